@@ -0,0 +1,142 @@
+// Host-side benchmark of the decimation of high-rate series.
+//
+// Feeds a million samples of a synthetic signal (a noisy sine, with
+// occasional spikes) through the Decimator, in batches of various sizes,
+// and reports the time per sample. For comparison, also runs the classic
+// LTTB over a buffer holding all the samples, which is what the Decimator
+// avoids: its memory use depends only on the number of columns.
+//
+// Usage:
+//
+//   bazel run -c opt //:decimation_benchmark
+//
+// The numbers are meant for comparing the approaches against each other on
+// the same host; absolute times do not translate to the microcontroller.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "roo_dashboard/core/decimator.h"
+
+using namespace roo_dashboard;
+
+namespace {
+
+static constexpr uint32_t kSampleCount = 1000000;
+static constexpr uint16_t kColumns = 320;
+
+std::vector<float> MakeSignal() {
+  std::vector<float> samples(kSampleCount);
+  uint32_t state = 12345;
+  for (uint32_t i = 0; i < kSampleCount; ++i) {
+    state = state * 1664525 + 1013904223;
+    float noise = (state >> 8) / float(1 << 24) - 0.5f;
+    float v = 50 + 40 * sinf(i * 0.0001f) + 5 * noise;
+    if ((state >> 20) == 0) v += 30;  // Rare spike.
+    samples[i] = v;
+  }
+  return samples;
+}
+
+// Prevents the compiler from optimizing the work away.
+volatile float sink;
+
+template <typename Fn>
+void Measure(const char* name, Fn fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto end = std::chrono::steady_clock::now();
+  double ns =
+      std::chrono::duration<double, std::nano>(end - start).count() /
+      kSampleCount;
+  printf("  %-28s %8.2f ns/sample\n", name, ns);
+}
+
+// Classic LTTB, over all the samples, picking one sample per column (plus
+// the first and the last sample). Returns the picked values.
+std::vector<float> FullLttb(const std::vector<float>& data, uint32_t buckets) {
+  std::vector<float> out;
+  out.reserve(buckets + 2);
+  out.push_back(data[0]);
+  double every = (double)(data.size() - 2) / buckets;
+  uint32_t a = 0;
+  for (uint32_t i = 0; i < buckets; ++i) {
+    uint32_t avg_start = (uint32_t)((i + 1) * every) + 1;
+    uint32_t avg_end =
+        std::min<uint32_t>((uint32_t)((i + 2) * every) + 1, data.size());
+    double avg_x = 0, avg_y = 0;
+    for (uint32_t j = avg_start; j < avg_end; ++j) {
+      avg_x += j;
+      avg_y += data[j];
+    }
+    uint32_t avg_count = avg_end - avg_start;
+    if (avg_count > 0) {
+      avg_x /= avg_count;
+      avg_y /= avg_count;
+    } else {
+      avg_x = data.size() - 1;
+      avg_y = data.back();
+    }
+    uint32_t range_start = (uint32_t)(i * every) + 1;
+    uint32_t range_end = (uint32_t)((i + 1) * every) + 1;
+    double max_area = -1;
+    uint32_t next_a = range_start;
+    for (uint32_t j = range_start; j < range_end; ++j) {
+      double area = fabs((a - avg_x) * (data[j] - data[a]) -
+                         ((double)a - j) * (avg_y - data[a]));
+      if (area > max_area) {
+        max_area = area;
+        next_a = j;
+      }
+    }
+    out.push_back(data[next_a]);
+    a = next_a;
+  }
+  out.push_back(data.back());
+  return out;
+}
+
+}  // namespace
+
+int main() {
+  std::vector<float> samples = MakeSignal();
+  uint32_t per_column = kSampleCount / kColumns;
+  printf("%u samples, %u columns, %u samples per column:\n", kSampleCount,
+         kColumns, per_column);
+  for (uint32_t batch : {1u, 16u, 256u, 4096u}) {
+    char name[40];
+    snprintf(name, sizeof(name), "Decimator, batch %u", batch);
+    Decimator decimator(kColumns, per_column);
+    Measure(name, [&]() {
+      for (uint32_t i = 0; i < kSampleCount; i += batch) {
+        decimator.add(&samples[i], std::min(batch, kSampleCount - i));
+      }
+      sink = decimator.selected(decimator.columnCount() - 2);
+    });
+  }
+  std::vector<float> picked;
+  Measure("Full-buffer LTTB", [&]() {
+    picked = FullLttb(samples, kColumns);
+    sink = picked[kColumns / 2];
+  });
+  printf("Memory:\n");
+  printf("  %-28s %8zu bytes\n", "Decimator",
+         sizeof(Decimator) + kColumns * sizeof(ColumnEnvelope));
+  printf("  %-28s %8zu bytes\n", "Full-buffer LTTB",
+         kSampleCount * sizeof(float));
+
+  // How closely the Decimator's picks follow the classic LTTB.
+  Decimator decimator(kColumns, per_column);
+  decimator.add(samples.data(), kSampleCount);
+  double error = 0;
+  uint32_t columns = std::min<uint32_t>(decimator.columnCount() - 1, kColumns);
+  for (uint32_t i = 0; i < columns; ++i) {
+    error += fabs(decimator.selected(i) - picked[i + 1]);
+  }
+  printf("Mean difference from the classic LTTB: %.3f\n", error / columns);
+  return 0;
+}
@@ -0,0 +1,473 @@
+// Host-side rendering benchmark for the meters.
+//
+// Renders each meter into an in-memory device, drives it with value
+// sequences resembling real sensor data, and reports, per frame: the time
+// spent repainting, the number of pixels written to the device, the number
+// of calls into the device, and the number of heap allocations.
+//
+// Usage:
+//
+//   bazel run -c opt //:meters_benchmark [-- <scenario name filter>]
+//
+// The numbers are meant for comparing revisions against each other on the
+// same host; absolute times do not translate to the microcontroller.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "roo_dashboard/meters/numeric_readout.h"
+#include "roo_dashboard/meters/percent_progress_bar.h"
+#include "roo_dashboard/meters/radial_gauge.h"
+#include "roo_dashboard/meters/stacked_bar.h"
+#include "roo_dashboard/meters/strip_chart.h"
+#include "roo_dashboard/meters/thermometer.h"
+#include "roo_dashboard/meters/vertical_bar.h"
+#include "roo_display.h"
+#include "roo_display/core/device.h"
+#include "roo_display/core/offscreen.h"
+#include "roo_smooth_fonts/NotoSans_Regular/27.h"
+#include "roo_windows/core/application.h"
+#include "roo_windows/core/environment.h"
+
+using namespace roo_display;
+using namespace roo_windows;
+using namespace roo_dashboard;
+
+namespace {
+
+// Heap allocation counters, updated by the global operator new below.
+uint64_t alloc_count = 0;
+uint64_t alloc_bytes = 0;
+
+}  // namespace
+
+void* operator new(size_t size) {
+  ++alloc_count;
+  alloc_bytes += size;
+  void* p = malloc(size == 0 ? 1 : size);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+namespace {
+
+static constexpr int16_t kScreenWidth = 480;
+static constexpr int16_t kScreenHeight = 320;
+
+// Display device that forwards to an in-memory one, counting the calls and
+// the pixels written.
+class CountingDevice : public DisplayDevice {
+ public:
+  CountingDevice(DisplayOutput& delegate, int16_t width, int16_t height)
+      : DisplayDevice(width, height),
+        delegate_(delegate),
+        calls_(0),
+        pixels_(0) {}
+
+  void setAddress(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                  BlendingMode mode) override {
+    ++calls_;
+    delegate_.setAddress(x0, y0, x1, y1, mode);
+  }
+
+  void write(Color* color, uint32_t pixel_count) override {
+    ++calls_;
+    pixels_ += pixel_count;
+    delegate_.write(color, pixel_count);
+  }
+
+  void writePixels(BlendingMode mode, Color* color, int16_t* x, int16_t* y,
+                   uint16_t pixel_count) override {
+    ++calls_;
+    pixels_ += pixel_count;
+    delegate_.writePixels(mode, color, x, y, pixel_count);
+  }
+
+  void fillPixels(BlendingMode mode, Color color, int16_t* x, int16_t* y,
+                  uint16_t pixel_count) override {
+    ++calls_;
+    pixels_ += pixel_count;
+    delegate_.fillPixels(mode, color, x, y, pixel_count);
+  }
+
+  void writeRects(BlendingMode mode, Color* color, int16_t* x0, int16_t* y0,
+                  int16_t* x1, int16_t* y1, uint16_t count) override {
+    ++calls_;
+    pixels_ += area(x0, y0, x1, y1, count);
+    delegate_.writeRects(mode, color, x0, y0, x1, y1, count);
+  }
+
+  void fillRects(BlendingMode mode, Color color, int16_t* x0, int16_t* y0,
+                 int16_t* x1, int16_t* y1, uint16_t count) override {
+    ++calls_;
+    pixels_ += area(x0, y0, x1, y1, count);
+    delegate_.fillRects(mode, color, x0, y0, x1, y1, count);
+  }
+
+  void resetCounters() {
+    calls_ = 0;
+    pixels_ = 0;
+  }
+
+  uint64_t calls() const { return calls_; }
+  uint64_t pixels() const { return pixels_; }
+
+ private:
+  static uint64_t area(const int16_t* x0, const int16_t* y0, const int16_t* x1,
+                       const int16_t* y1, uint16_t count) {
+    uint64_t total = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+      total += (uint64_t)(x1[i] - x0[i] + 1) * (y1[i] - y0[i] + 1);
+    }
+    return total;
+  }
+
+  DisplayOutput& delegate_;
+  uint64_t calls_;
+  uint64_t pixels_;
+};
+
+// Deterministic pseudo-random generator, so that runs are comparable.
+class Lcg {
+ public:
+  Lcg(uint32_t seed) : state_(seed) {}
+
+  // Returns a value uniformly distributed in [-1, 1].
+  float next() {
+    state_ = state_ * 1664525u + 1013904223u;
+    return (state_ >> 8) * (2.0f / (1 << 24)) - 1.0f;
+  }
+
+ private:
+  uint32_t state_;
+};
+
+// Value sequences, modeled after recorded sensor traces, scaled to
+// [min, max].
+enum class Trace {
+  // Slow drift with little noise, e.g. room temperature sampled every
+  // second. Most updates are below the display resolution.
+  kDrift,
+
+  // A noisy signal, e.g. current draw of a pump: large sample-to-sample
+  // jitter around a slowly moving mean.
+  kNoisy,
+
+  // Full-range ramps up and down, e.g. a tank filling and draining.
+  kSweep,
+
+  // Piecewise constant, with occasional jumps, e.g. a thermostat setpoint.
+  kSteps,
+};
+
+const char* TraceName(Trace trace) {
+  switch (trace) {
+    case Trace::kDrift:
+      return "drift";
+    case Trace::kNoisy:
+      return "noisy";
+    case Trace::kSweep:
+      return "sweep";
+    case Trace::kSteps:
+    default:
+      return "steps";
+  }
+}
+
+std::vector<float> MakeTrace(Trace trace, float min, float max, int count) {
+  std::vector<float> result;
+  result.reserve(count);
+  Lcg rng(12345);
+  float range = max - min;
+  float v = 0.5f;
+  for (int i = 0; i < count; ++i) {
+    switch (trace) {
+      case Trace::kDrift: {
+        v = 0.5f + 0.2f * sinf(i * 0.005f) + 0.002f * rng.next();
+        break;
+      }
+      case Trace::kNoisy: {
+        v = 0.5f + 0.25f * sinf(i * 0.01f) + 0.05f * rng.next();
+        break;
+      }
+      case Trace::kSweep: {
+        int phase = i % 400;
+        v = (phase < 200 ? phase : 400 - phase) / 200.0f;
+        break;
+      }
+      case Trace::kSteps: {
+        if (i % 50 == 0) v = 0.5f + 0.45f * rng.next();
+        break;
+      }
+    }
+    result.push_back(min + std::min(std::max(v, 0.0f), 1.0f) * range);
+  }
+  return result;
+}
+
+struct Stats {
+  int frames = 0;
+  double total_us = 0;
+  double max_us = 0;
+  uint64_t pixels = 0;
+  uint64_t calls = 0;
+  uint64_t allocs = 0;
+  uint64_t alloc_bytes = 0;
+};
+
+void PrintHeader() {
+  printf("%-34s %7s %9s %9s %10s %9s %8s %9s\n", "scenario", "frames",
+         "us/frame", "max us", "px/frame", "calls/fr", "allocs/fr",
+         "bytes/fr");
+}
+
+void PrintStats(const std::string& name, const Stats& stats) {
+  double n = std::max(stats.frames, 1);
+  printf("%-34s %7d %9.2f %9.2f %10.1f %9.2f %8.3f %9.1f\n", name.c_str(),
+         stats.frames, stats.total_us / n, stats.max_us, stats.pixels / n,
+         stats.calls / n, stats.allocs / n, stats.alloc_bytes / n);
+}
+
+// A benchmark scenario: a widget, the size of the area it is laid out in, and
+// a function that feeds it a value.
+struct Scenario {
+  std::string name;
+  Dimensions size;
+  std::function<Widget*(const Environment& env)> create;
+  std::function<void(Widget& widget, float value)> update;
+  float min;
+  float max;
+};
+
+// Renders the scenario for each value in the trace, and prints the stats of
+// the initial (full) paint and of the subsequent frames.
+void Run(const Scenario& scenario, Trace trace, int frames) {
+  Offscreen<Rgb565> offscreen(kScreenWidth, kScreenHeight, color::Black);
+  CountingDevice device(offscreen.output(), kScreenWidth, kScreenHeight);
+  Display display(device);
+  display.init(color::Black);
+  Environment env;
+  Application app(&env, display);
+  std::unique_ptr<Widget> widget(scenario.create(env));
+  app.add(*widget, Box(0, 0, scenario.size.width() - 1,
+                       scenario.size.height() - 1));
+
+  std::string name = scenario.name + "/" + TraceName(trace);
+  Stats initial;
+  {
+    device.resetCounters();
+    uint64_t allocs = alloc_count;
+    uint64_t bytes = alloc_bytes;
+    auto start = std::chrono::steady_clock::now();
+    app.refresh();
+    auto end = std::chrono::steady_clock::now();
+    initial.frames = 1;
+    initial.total_us = initial.max_us =
+        std::chrono::duration<double, std::micro>(end - start).count();
+    initial.pixels = device.pixels();
+    initial.calls = device.calls();
+    initial.allocs = alloc_count - allocs;
+    initial.alloc_bytes = alloc_bytes - bytes;
+  }
+  PrintStats(name + " (first)", initial);
+
+  std::vector<float> values =
+      MakeTrace(trace, scenario.min, scenario.max, frames);
+  Stats stats;
+  for (float value : values) {
+    device.resetCounters();
+    uint64_t allocs = alloc_count;
+    uint64_t bytes = alloc_bytes;
+    auto start = std::chrono::steady_clock::now();
+    scenario.update(*widget, value);
+    app.refresh();
+    auto end = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count();
+    ++stats.frames;
+    stats.total_us += us;
+    stats.max_us = std::max(stats.max_us, us);
+    stats.pixels += device.pixels();
+    stats.calls += device.calls();
+    stats.allocs += alloc_count - allocs;
+    stats.alloc_bytes += alloc_bytes - bytes;
+  }
+  PrintStats(name, stats);
+}
+
+std::vector<Scenario> Scenarios() {
+  std::vector<Scenario> result;
+  result.push_back(Scenario{
+      .name = "RadialGauge",
+      .size = Dimensions(320, 240),
+      .create = [](const Environment& env) -> Widget* {
+        return new RadialGauge(env);
+      },
+      .update =
+          [](Widget& widget, float value) {
+            static_cast<RadialGauge&>(widget).setValue(value);
+          },
+      .min = 0,
+      .max = 100});
+  result.push_back(Scenario{
+      .name = "RadialGauge[cached]",
+      .size = Dimensions(320, 240),
+      .create = [](const Environment& env) -> Widget* {
+        RadialGauge* gauge = new RadialGauge(env);
+        gauge->setScaleCacheEnabled(true);
+        return gauge;
+      },
+      .update =
+          [](Widget& widget, float value) {
+            static_cast<RadialGauge&>(widget).setValue(value);
+          },
+      .min = 0,
+      .max = 100});
+  result.push_back(Scenario{
+      .name = "Thermometer",
+      .size = Dimensions(98, 280),
+      .create = [](const Environment& env) -> Widget* {
+        return new Thermometer(env);
+      },
+      .update =
+          [](Widget& widget, float value) {
+            static_cast<Thermometer&>(widget).setTemperature(value);
+          },
+      .min = 8,
+      .max = 32});
+  result.push_back(Scenario{
+      .name = "VerticalBar",
+      .size = Dimensions(240, 60),
+      .create = [](const Environment& env) -> Widget* {
+        return new VerticalBar(
+            env, 2.0, 10,
+            [](float val) { return val < 150 ? color::Green : color::Red; },
+            "Level", "%.1f%%");
+      },
+      .update =
+          [](Widget& widget, float value) {
+            static_cast<VerticalBar&>(widget).setValue(value);
+          },
+      .min = 0,
+      .max = 100});
+  result.push_back(Scenario{
+      .name = "VerticalBar[threshold]",
+      .size = Dimensions(240, 60),
+      .create = [](const Environment& env) -> Widget* {
+        return new BasicVerticalBar<ThresholdBarColor>(
+            env, 2.0, 10,
+            ThresholdBarColor{
+                .threshold = 150, .below = color::Green, .above = color::Red},
+            "Level", "%.1f%%");
+      },
+      .update =
+          [](Widget& widget, float value) {
+            static_cast<BasicVerticalBar<ThresholdBarColor>&>(widget).setValue(
+                value);
+          },
+      .min = 0,
+      .max = 100});
+  // Three phases, at different fractions of the value.
+  result.push_back(Scenario{
+      .name = "StackedBar",
+      .size = Dimensions(240, 25),
+      .create = [](const Environment& env) -> Widget* {
+        return new StackedBar(env, 0.7,
+                              {color::Red, color::Green, color::Blue});
+      },
+      .update =
+          [](Widget& widget, float value) {
+            float values[] = {value, value * 0.8f, value * 0.5f};
+            static_cast<StackedBar&>(widget).setValues(values);
+          },
+      .min = 0,
+      .max = 100});
+  result.push_back(Scenario{
+      .name = "StripChart",
+      .size = Dimensions(240, 80),
+      .create = [](const Environment& env) -> Widget* {
+        return new StripChart(env, 240, 0, 100);
+      },
+      .update =
+          [](Widget& widget, float value) {
+            static_cast<StripChart&>(widget).addSample(value);
+          },
+      .min = 0,
+      .max = 100});
+  result.push_back(Scenario{
+      .name = "PercentProgressBar",
+      .size = Dimensions(240, 30),
+      .create = [](const Environment& env) -> Widget* {
+        return new PercentProgressBar(env);
+      },
+      .update =
+          [](Widget& widget, float value) {
+            static_cast<PercentProgressBar&>(widget).setProgress(
+                (uint16_t)value);
+          },
+      .min = 0,
+      .max = 1024});
+  // Full-width bar, as on a 320x240 screen; the label is repainted over the
+  // bar on every change.
+  result.push_back(Scenario{
+      .name = "PercentProgressBar[320]",
+      .size = Dimensions(320, 30),
+      .create = [](const Environment& env) -> Widget* {
+        return new PercentProgressBar(env);
+      },
+      .update =
+          [](Widget& widget, float value) {
+            static_cast<PercentProgressBar&>(widget).setProgress(
+                (uint16_t)value);
+          },
+      .min = 0,
+      .max = 1024});
+  result.push_back(Scenario{
+      .name = "NumericReadout",
+      .size = Dimensions(120, 40),
+      .create = [](const Environment& env) -> Widget* {
+        return new NumericReadout(env, font_NotoSans_Regular_27(),
+                                  NumberFormat{.precision = 1,
+                                               .suffix = "°C"},
+                                  5);
+      },
+      .update =
+          [](Widget& widget, float value) {
+            static_cast<NumericReadout&>(widget).setValue(value);
+          },
+      .min = 8,
+      .max = 32});
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* filter = argc > 1 ? argv[1] : "";
+  static constexpr int kFrames = 2000;
+  PrintHeader();
+  for (const Scenario& scenario : Scenarios()) {
+    if (strstr(scenario.name.c_str(), filter) == nullptr) continue;
+    for (Trace trace :
+         {Trace::kDrift, Trace::kNoisy, Trace::kSweep, Trace::kSteps}) {
+      Run(scenario, trace, kFrames);
+    }
+  }
+  return 0;
+}
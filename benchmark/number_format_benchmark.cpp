@@ -0,0 +1,118 @@
+// Host-side benchmark of caption formatting.
+//
+// Compares the printf-style path previously used by the meters
+// (roo_io::StringPrintf) with FormattedNumber, for the caption formats that
+// the meters use. Reports the time per formatted caption, and the number of
+// heap allocations.
+//
+// Usage:
+//
+//   bazel run -c opt //:number_format_benchmark
+//
+// The numbers are meant for comparing the approaches against each other on
+// the same host; absolute times do not translate to the microcontroller.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "roo_dashboard/core/number_format.h"
+#include "roo_io/text/string_printf.h"
+
+using namespace roo_dashboard;
+
+namespace {
+
+// Heap allocation counter, updated by the global operator new below.
+uint64_t alloc_count = 0;
+
+}  // namespace
+
+void* operator new(size_t size) {
+  ++alloc_count;
+  void* p = malloc(size == 0 ? 1 : size);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+namespace {
+
+static constexpr int kIterations = 1000000;
+
+struct Case {
+  const char* printf_template;
+  float min;
+  float max;
+};
+
+const Case kCases[] = {
+    {"%.1f°C", -10, 40},                  // Thermometer.
+    {"%.1f%%", 0, 100},                   // VerticalBar.
+    {"%2.f", 0, 100},                     // RadialGauge scale labels.
+    {"Flow: %+7.2f l/min", -500, 500},    // A longer caption.
+};
+
+std::vector<float> MakeValues(float min, float max) {
+  std::vector<float> values(4096);
+  uint32_t state = 12345;
+  for (float& v : values) {
+    state = state * 1664525 + 1013904223;
+    v = min + (max - min) * (state >> 8) / float(1 << 24);
+  }
+  return values;
+}
+
+// Prevents the compiler from optimizing the formatting away.
+volatile uint32_t sink;
+
+template <typename Fn>
+void Measure(const char* name, const std::vector<float>& values, Fn fn) {
+  uint64_t allocs_before = alloc_count;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    sink = sink + fn(values[i % values.size()]);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double ns =
+      std::chrono::duration<double, std::nano>(end - start).count() /
+      kIterations;
+  printf("  %-28s %8.1f ns %8.2f allocs\n", name, ns,
+         (double)(alloc_count - allocs_before) / kIterations);
+}
+
+}  // namespace
+
+int main() {
+  printf("Per formatted caption (%d iterations):\n", kIterations);
+  for (const Case& c : kCases) {
+    std::vector<float> values = MakeValues(c.min, c.max);
+    NumberFormat format;
+    if (!NumberFormat::Parse(c.printf_template, format)) {
+      printf("Unsupported template: %s\n", c.printf_template);
+      return 1;
+    }
+    printf("\"%s\":\n", c.printf_template);
+    Measure("StringPrintf", values, [&](float v) {
+      return (uint32_t)roo_io::StringPrintf(c.printf_template, v).size();
+    });
+    Measure("FormattedNumber", values, [&](float v) {
+      return (uint32_t)FormattedNumber(v, format).size();
+    });
+    // As passed to TextLabel::setText(), which keeps a std::string.
+    Measure("FormattedNumber + string", values, [&](float v) {
+      return (uint32_t)std::string(FormattedNumber(v, format).c_str()).size();
+    });
+  }
+  return 0;
+}
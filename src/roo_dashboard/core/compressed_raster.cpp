@@ -0,0 +1,171 @@
+#include "roo_dashboard/core/compressed_raster.h"
+
+#include <memory>
+
+#include "roo_display.h"
+#include "roo_display/core/offscreen.h"
+
+using namespace roo_display;
+
+namespace roo_dashboard {
+
+CompressedRaster::CompressedRaster()
+    : extents_(0, 0, -1, -1), cursor_y_(-1), cursor_x_(0), cursor_run_(0) {}
+
+void CompressedRaster::clear() {
+  extents_ = Box(0, 0, -1, -1);
+  palette_.clear();
+  palette_.shrink_to_fit();
+  row_offsets_.clear();
+  row_offsets_.shrink_to_fit();
+  runs_.clear();
+  runs_.shrink_to_fit();
+  cursor_y_ = -1;
+}
+
+size_t CompressedRaster::memoryUsage() const {
+  return palette_.size() * sizeof(Color) +
+         row_offsets_.size() * sizeof(uint16_t) + runs_.size() * sizeof(Run);
+}
+
+int CompressedRaster::findOrAddColor(Color color) {
+  for (size_t i = 0; i < palette_.size(); ++i) {
+    if (palette_[i] == color) return i;
+  }
+  if (palette_.size() >= 256) return -1;
+  palette_.push_back(color);
+  return palette_.size() - 1;
+}
+
+bool CompressedRaster::capture(const Drawable& drawable, Box extents,
+                               int16_t strip_height) {
+  clear();
+  if (extents.empty()) return true;
+  int16_t width = extents.width();
+  if (strip_height > extents.height()) strip_height = extents.height();
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[width * strip_height * 4]);
+  std::unique_ptr<int16_t[]> xs(new int16_t[width]);
+  std::unique_ptr<int16_t[]> ys(new int16_t[width]);
+  std::unique_ptr<Color[]> colors(new Color[width]);
+  for (int16_t i = 0; i < width; ++i) xs[i] = extents.xMin() + i;
+
+  row_offsets_.reserve(extents.height() + 1);
+  for (int16_t y0 = extents.yMin(); y0 <= extents.yMax(); y0 += strip_height) {
+    int16_t y1 = std::min<int16_t>(y0 + strip_height - 1, extents.yMax());
+    Offscreen<Argb8888> strip(Box(extents.xMin(), y0, extents.xMax(), y1),
+                              buffer.get());
+    {
+      DrawingContext dc(strip);
+      dc.fill(color::Transparent);
+    }
+    {
+      // As when drawing to a screen, where the drawables (e.g. the gauge
+      // face, then the scale) are drawn front to back.
+      DrawingContext dc(strip);
+      dc.setWriteOnce();
+      dc.draw(drawable);
+    }
+    for (int16_t y = y0; y <= y1; ++y) {
+      std::fill(&ys[0], &ys[width], y);
+      strip.readColors(&xs[0], &ys[0], width, &colors[0]);
+      row_offsets_.push_back(runs_.size());
+      int16_t x = 0;
+      while (x < width) {
+        Color c = colors[x];
+        int16_t len = 1;
+        while (x + len < width && len < 256 && colors[x + len] == c) ++len;
+        int idx = findOrAddColor(c);
+        if (idx < 0 || runs_.size() >= 0xFFFF) {
+          clear();
+          return false;
+        }
+        runs_.push_back((Run)(idx << 8 | (len - 1)));
+        x += len;
+      }
+    }
+  }
+  row_offsets_.push_back(runs_.size());
+  runs_.shrink_to_fit();
+  extents_ = extents;
+  return true;
+}
+
+void CompressedRaster::seek(int16_t x, int16_t y) const {
+  if (y != cursor_y_ || x < cursor_x_) {
+    cursor_y_ = y;
+    cursor_x_ = extents_.xMin();
+    cursor_run_ = row_offsets_[y - extents_.yMin()];
+  }
+  while (true) {
+    int16_t len = runLength(runs_[cursor_run_]);
+    if (x < cursor_x_ + len) return;
+    cursor_x_ += len;
+    ++cursor_run_;
+  }
+}
+
+void CompressedRaster::readColors(const int16_t* x, const int16_t* y,
+                                  uint32_t count, Color* result) const {
+  while (count-- > 0) {
+    if (!extents_.contains(*x, *y)) {
+      *result = color::Transparent;
+    } else {
+      seek(*x, *y);
+      *result = palette_[runColor(runs_[cursor_run_])];
+    }
+    ++x;
+    ++y;
+    ++result;
+  }
+}
+
+bool CompressedRaster::readColorRect(int16_t xMin, int16_t yMin, int16_t xMax,
+                                     int16_t yMax, Color* result) const {
+  if (xMin < extents_.xMin() || xMax > extents_.xMax() ||
+      yMin < extents_.yMin() || yMax > extents_.yMax()) {
+    // Fall back to the slow path.
+    return Rasterizable::readColorRect(xMin, yMin, xMax, yMax, result);
+  }
+  // Check if the rectangle is covered by runs of a single color.
+  bool uniform = true;
+  uint8_t color_idx = 0;
+  for (int16_t y = yMin; y <= yMax && uniform; ++y) {
+    seek(xMin, y);
+    Run run = runs_[cursor_run_];
+    if (y == yMin) {
+      color_idx = runColor(run);
+    } else if (runColor(run) != color_idx) {
+      uniform = false;
+      break;
+    }
+    // Adjacent runs may have the same color (runs are split at 256 pixels).
+    int16_t x = cursor_x_ + runLength(run);
+    while (x <= xMax) {
+      seek(x, y);
+      run = runs_[cursor_run_];
+      if (runColor(run) != color_idx) {
+        uniform = false;
+        break;
+      }
+      x = cursor_x_ + runLength(run);
+    }
+  }
+  if (uniform) {
+    *result = palette_[color_idx];
+    return true;
+  }
+  // Expand the runs.
+  for (int16_t y = yMin; y <= yMax; ++y) {
+    int16_t x = xMin;
+    while (x <= xMax) {
+      seek(x, y);
+      Run run = runs_[cursor_run_];
+      int16_t end = std::min<int16_t>(cursor_x_ + runLength(run) - 1, xMax);
+      result = std::fill_n(result, end - x + 1, palette_[runColor(run)]);
+      x = end + 1;
+    }
+  }
+  return false;
+}
+
+}  // namespace roo_dashboard
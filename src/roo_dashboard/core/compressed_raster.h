@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "roo_display/color/color.h"
+#include "roo_display/core/drawable.h"
+#include "roo_display/core/rasterizable.h"
+
+namespace roo_dashboard {
+
+// A read-only image, captured from an arbitrary drawable, and stored as
+// per-row runs of palette-indexed colors. Meant for caching pre-rendered,
+// mostly flat artwork (such as gauge scales), which compresses very well:
+// typically to a few bytes per row.
+//
+// Each run takes 2 bytes (palette index and length), and each row takes
+// additional 2 bytes of index. The palette is limited to 256 colors.
+class CompressedRaster : public roo_display::Rasterizable {
+ public:
+  CompressedRaster();
+
+  // Renders the drawable, clipped to the specified extents, and stores the
+  // result (replacing any previous content). The drawable is rendered in the
+  // write-once mode, i.e. whatever it draws first stays on top. Rendering is done in horizontal
+  // strips of `strip_height` rows, so that the temporary memory overhead is
+  // bounded by 4 * extents.width() * strip_height bytes.
+  //
+  // Returns false, leaving the raster empty, if the drawable has too many
+  // distinct colors to be captured.
+  bool capture(const roo_display::Drawable& drawable, roo_display::Box extents,
+               int16_t strip_height = 16);
+
+  // Releases the content.
+  void clear();
+
+  bool empty() const { return row_offsets_.empty(); }
+
+  // Returns the number of bytes used by the stored image.
+  size_t memoryUsage() const;
+
+  roo_display::Box extents() const override { return extents_; }
+
+  void readColors(const int16_t* x, const int16_t* y, uint32_t count,
+                  roo_display::Color* result) const override;
+
+  bool readColorRect(int16_t xMin, int16_t yMin, int16_t xMax, int16_t yMax,
+                     roo_display::Color* result) const override;
+
+ private:
+  // Run encoding: palette index in the high byte, (length - 1) in the low
+  // byte.
+  typedef uint16_t Run;
+
+  static uint8_t runColor(Run run) { return run >> 8; }
+  static int16_t runLength(Run run) { return (run & 0xFF) + 1; }
+
+  // Positions the cursor at the run containing the specified pixel, which
+  // must be within extents.
+  void seek(int16_t x, int16_t y) const;
+
+  // Returns the palette index for the specified color, adding it to the
+  // palette if needed. Returns -1 if the palette is full.
+  int findOrAddColor(roo_display::Color color);
+
+  roo_display::Box extents_;
+  std::vector<roo_display::Color> palette_;
+
+  // For each row, the index of its first run in runs_. Has an extra entry at
+  // the end.
+  std::vector<uint16_t> row_offsets_;
+  std::vector<Run> runs_;
+
+  // Cursor, to make sequential reads O(1) per pixel.
+  mutable int16_t cursor_y_;
+  mutable int16_t cursor_x_;  // Start of the cursor run.
+  mutable uint16_t cursor_run_;
+};
+
+}  // namespace roo_dashboard
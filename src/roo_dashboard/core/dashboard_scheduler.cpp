@@ -0,0 +1,113 @@
+#include "roo_dashboard/core/dashboard_scheduler.h"
+
+#include <algorithm>
+
+namespace roo_dashboard {
+
+namespace {
+
+// Weight of the newest measurement in the cost average.
+static constexpr int kCostSmoothingShift = 2;  // 1/4.
+
+}  // namespace
+
+DashboardScheduler::DashboardScheduler(roo_time::Duration frame_budget)
+    : frame_budget_(frame_budget), stats_{} {}
+
+int DashboardScheduler::addSlot(std::function<void(float)> apply,
+                                uint8_t priority) {
+  slots_.push_back(Slot{.apply = std::move(apply),
+                        .priority = priority,
+                        .pending = false,
+                        .value = 0,
+                        .since = roo_time::Uptime::Now(),
+                        .cost = 0});
+  return slots_.size() - 1;
+}
+
+void DashboardScheduler::post(int slot, float value) {
+  Slot& s = slots_[slot];
+  ++stats_.posted;
+  if (s.pending) {
+    ++stats_.coalesced;
+  } else {
+    s.pending = true;
+    s.since = roo_time::Uptime::Now();
+  }
+  s.value = value;
+}
+
+uint16_t DashboardScheduler::pendingCount() const {
+  uint16_t count = 0;
+  for (const Slot& s : slots_) count += s.pending;
+  return count;
+}
+
+void DashboardScheduler::runFrame() {
+  ++stats_.frames;
+  applied_.clear();
+  order_.clear();
+  for (int i = 0; i < (int)slots_.size(); ++i) {
+    if (slots_[i].pending) order_.push_back(i);
+  }
+  if (order_.empty()) return;
+  roo_time::Uptime now = roo_time::Uptime::Now();
+  auto urgency = [&](int i) {
+    const Slot& s = slots_[i];
+    return (uint64_t)(now - s.since).inMicros() * (s.priority + 1);
+  };
+  std::sort(order_.begin(), order_.end(),
+            [&](int a, int b) { return urgency(a) > urgency(b); });
+  uint64_t budget = frame_budget_.inMicros();
+  uint64_t spent = 0;
+  for (int i : order_) {
+    Slot& s = slots_[i];
+    if (!applied_.empty() && spent + s.cost > budget) {
+      // Doesn't fit; maybe a cheaper one further down the list does.
+      ++stats_.deferred;
+      continue;
+    }
+    spent += s.cost;
+    uint32_t latency = (now - s.since).inMicros();
+    stats_.max_latency_micros = std::max(stats_.max_latency_micros, latency);
+    ++stats_.applied;
+    s.pending = false;
+    applied_.push_back(i);
+    s.apply(s.value);
+  }
+}
+
+void DashboardScheduler::frameFinished(roo_time::Duration paint_time) {
+  if (applied_.empty()) return;
+  uint64_t total = paint_time.inMicros();
+  // Slots with no estimate yet are weighted as the average of the others
+  // (or all equally, if none has an estimate).
+  uint64_t known_sum = 0;
+  uint32_t known_count = 0;
+  for (int i : applied_) {
+    if (slots_[i].cost == 0) continue;
+    known_sum += slots_[i].cost;
+    ++known_count;
+  }
+  uint64_t unknown_weight = known_count == 0 ? 1 : known_sum / known_count;
+  auto weight = [&](const Slot& s) -> uint64_t {
+    return s.cost == 0 ? unknown_weight : s.cost;
+  };
+  uint64_t weight_sum = 0;
+  for (int i : applied_) weight_sum += weight(slots_[i]);
+  for (int i : applied_) {
+    Slot& s = slots_[i];
+    uint32_t share = total * weight(s) / weight_sum;
+    if (s.cost == 0) {
+      // At least 1, so that the slot doesn't stay 'unknown' when its share
+      // rounds down to zero. (The average below never decays to zero.)
+      s.cost = std::max<uint32_t>(share, 1);
+    } else {
+      s.cost = s.cost - (s.cost >> kCostSmoothingShift) +
+               (share >> kCostSmoothingShift);
+    }
+  }
+  applied_.clear();
+}
+
+}  // namespace roo_dashboard
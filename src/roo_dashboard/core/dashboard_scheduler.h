@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "roo_time.h"
+
+namespace roo_dashboard {
+
+struct SchedulerStats {
+  // Number of frames run.
+  uint32_t frames;
+
+  // Number of values posted.
+  uint32_t posted;
+
+  // Values overwritten by a newer one before being applied.
+  uint32_t coalesced;
+
+  // Values applied (i.e., passed to the meters).
+  uint32_t applied;
+
+  // Number of times a pending update got carried over to the next frame,
+  // because it did not fit in the budget.
+  uint32_t deferred;
+
+  // The longest time, in microseconds, between an update becoming pending
+  // and being applied.
+  uint32_t max_latency_micros;
+};
+
+// Spreads meter updates over frames, so that the repaint cost stays within
+// a per-frame time budget, rather than landing in one burst when many
+// meters receive values in the same tick.
+//
+// Each meter (or any other target of updates) is registered as a slot, with
+// a function that applies a value to it (e.g., calls setValue()). New values
+// are posted to the slots; a value posted before the previous one got
+// applied replaces it. Once per frame, before the UI gets refreshed,
+// runFrame() applies the pending values, most urgent first, where the
+// urgency is the time the update has been pending, weighted by the slot's
+// priority. It stops when the estimated repaint cost of the applied updates
+// would exceed the budget; the rest is carried over to the next frame. At
+// least one update gets applied per frame, so that everything eventually
+// gets through.
+//
+// The repaint cost of each slot is learned from the measured frame time,
+// reported with frameFinished(), as an exponentially weighted moving
+// average. Until the first measurement, the cost of a slot is assumed to be
+// zero.
+//
+// Example:
+//
+//   DashboardScheduler scheduler(roo_time::Millis(10));
+//   int pressure = scheduler.addSlot([&](float v) { gauge.setValue(v); });
+//   ...
+//   scheduler.post(pressure, reading);
+//   ...
+//   void loop() {
+//     scheduler.runFrame();
+//     roo_time::Uptime start = roo_time::Uptime::Now();
+//     app.tick();
+//     scheduler.frameFinished(roo_time::Uptime::Now() - start);
+//   }
+//
+// Not thread-safe: to be used from the UI thread only. Values from other
+// threads can be passed via value channels, with the ChannelDrain sinks
+// posting to the scheduler.
+class DashboardScheduler {
+ public:
+  explicit DashboardScheduler(roo_time::Duration frame_budget);
+
+  // Registers a slot, and returns its id. Updates of slots with higher
+  // priority become urgent faster.
+  int addSlot(std::function<void(float)> apply, uint8_t priority = 0);
+
+  // Posts a new value to the slot.
+  void post(int slot, float value);
+
+  // Applies the most urgent pending values that fit in the frame budget.
+  void runFrame();
+
+  // Reports the time it took to repaint the updates applied by the last
+  // runFrame(). The time is attributed to the updated slots in proportion
+  // to their estimated costs.
+  void frameFinished(roo_time::Duration paint_time);
+
+  void setFrameBudget(roo_time::Duration frame_budget) {
+    frame_budget_ = frame_budget;
+  }
+
+  // Number of updates currently pending.
+  uint16_t pendingCount() const;
+
+  // Estimated repaint cost of an update of the slot, in microseconds; zero
+  // until measured.
+  uint32_t estimatedCostMicros(int slot) const { return slots_[slot].cost; }
+
+  const SchedulerStats& stats() const { return stats_; }
+
+  void resetStats() { stats_ = SchedulerStats{}; }
+
+ private:
+  struct Slot {
+    std::function<void(float)> apply;
+    uint8_t priority;
+    bool pending;
+    float value;
+
+    // When the pending update was first posted.
+    roo_time::Uptime since;
+
+    // EWMA of the repaint cost, in microseconds; zero if not yet measured,
+    // and at least 1 afterwards.
+    uint32_t cost;
+  };
+
+  roo_time::Duration frame_budget_;
+  std::vector<Slot> slots_;
+
+  // Slots updated by the last runFrame(). Kept between frames to avoid
+  // reallocations, as is the work list.
+  std::vector<int> applied_;
+  std::vector<int> order_;
+
+  SchedulerStats stats_;
+};
+
+}  // namespace roo_dashboard
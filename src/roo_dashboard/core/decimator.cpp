@@ -0,0 +1,128 @@
+#include "roo_dashboard/core/decimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace roo_dashboard {
+
+namespace {
+
+// Twice the area of the triangle (ax, ay), (bx, by), (cx, cy).
+inline float TriangleArea2(float ax, float ay, float bx, float by, float cx,
+                           float cy) {
+  return fabsf((ax - cx) * (by - ay) - (ax - bx) * (cy - ay));
+}
+
+}  // namespace
+
+Decimator::Decimator(uint16_t capacity, uint32_t samples_per_column)
+    : capacity_(std::max<uint16_t>(capacity, 3)),
+      samples_per_column_(std::max<uint32_t>(samples_per_column, 1)),
+      columns_(new ColumnEnvelope[capacity_]),
+      column_count_(0) {}
+
+void Decimator::clear() { column_count_ = 0; }
+
+void Decimator::startColumn() {
+  ColumnEnvelope& c = mutableColumn(column_count_);
+  ++column_count_;
+  c.filled = 0;
+  c.count = 0;
+  c.sum = 0;
+}
+
+void Decimator::add(const float* samples, size_t count) {
+  while (count > 0) {
+    if (column_count_ == 0 ||
+        column(column_count_ - 1).filled == samples_per_column_) {
+      startColumn();
+    }
+    ColumnEnvelope& c = mutableColumn(column_count_ - 1);
+    // Consume as much of the batch as fits in the current column, in a
+    // tight loop.
+    uint32_t n = std::min<size_t>(count, samples_per_column_ - c.filled);
+    uint32_t pos = c.filled;
+    uint32_t end = pos + n;
+    // Skip to the first valid sample, if the column has none yet.
+    for (; c.count == 0 && pos < end; ++pos, ++samples) {
+      float v = *samples;
+      if (std::isnan(v)) continue;
+      c.count = 1;
+      c.min = c.max = c.first = c.last = c.sum = v;
+      c.min_pos = c.max_pos = c.first_pos = c.last_pos = pos;
+    }
+    for (; pos < end; ++pos, ++samples) {
+      float v = *samples;
+      if (std::isnan(v)) continue;
+      ++c.count;
+      c.sum += v;
+      c.last = v;
+      c.last_pos = pos;
+      if (v < c.min) {
+        c.min = v;
+        c.min_pos = pos;
+      } else if (v > c.max) {
+        c.max = v;
+        c.max_pos = pos;
+      }
+    }
+    c.filled = end;
+    count -= n;
+    // Provisional, until the next column is complete. (If the column has
+    // no valid samples yet, last is undefined.)
+    if (c.count > 0) {
+      c.selected = c.last;
+      c.selected_pos = c.last_pos;
+    }
+    if (c.filled == samples_per_column_) completeColumn();
+  }
+}
+
+void Decimator::completeColumn() {
+  // Picks the value of the middle column (b), between the already picked
+  // value of the column before (a), and the mean of the one just completed
+  // (c). The x coordinates are in samples, relative to the start of b.
+  if (column_count_ < 2) return;
+  uint32_t n = column_count_ - 2;
+  ColumnEnvelope& b = mutableColumn(n);
+  if (b.empty()) return;
+  const ColumnEnvelope& c = column(n + 1);
+  float spc = samples_per_column_;
+  float cx, cy;
+  if (!c.empty()) {
+    cx = spc + (c.first_pos + c.last_pos) * 0.5f;
+    cy = c.mean();
+  } else {
+    cx = spc;
+    cy = b.mean();
+  }
+  float ax, ay;
+  if (n == 0 || column(n - 1).empty()) {
+    // Nothing to connect to; as in LTTB, start with the first point.
+    if (n == 0) {
+      b.selected = b.first;
+      b.selected_pos = b.first_pos;
+      return;
+    }
+    ax = -spc;
+    ay = cy;
+  } else {
+    const ColumnEnvelope& a = column(n - 1);
+    ax = (float)a.selected_pos - spc;
+    ay = a.selected;
+  }
+  const float values[] = {b.first, b.min, b.max, b.last};
+  const uint32_t positions[] = {b.first_pos, b.min_pos, b.max_pos, b.last_pos};
+  float best_area = -1;
+  for (int i = 0; i < 4; ++i) {
+    float area =
+        TriangleArea2(ax, ay, (float)positions[i], values[i], cx, cy);
+    if (area > best_area) {
+      best_area = area;
+      b.selected = values[i];
+      b.selected_pos = positions[i];
+    }
+  }
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace roo_dashboard {
+
+// Summary of the samples that fall into a single column of a chart.
+struct ColumnEnvelope {
+  // Number of samples consumed by the column, including NaNs.
+  uint32_t filled;
+
+  // Number of valid (non-NaN) samples. If zero, the values below are
+  // undefined.
+  uint32_t count;
+
+  float min;
+  float max;
+  float first;
+  float last;
+
+  // Positions of the min and the max, and of the first and the last valid
+  // sample, within the column (0 to samples per column - 1).
+  uint32_t min_pos;
+  uint32_t max_pos;
+  uint32_t first_pos;
+  uint32_t last_pos;
+
+  // Sum of the valid samples.
+  float sum;
+
+  // The value picked for the column by the largest-triangle-three-buckets
+  // (LTTB) method. See Decimator::selected().
+  float selected;
+  uint32_t selected_pos;
+
+  bool empty() const { return count == 0; }
+  float mean() const { return sum / count; }
+};
+
+// Reduces a high-rate series of samples to one ColumnEnvelope per fixed
+// number of samples, for display on a chart with one column per envelope.
+//
+// The envelopes of the most recent 'capacity' columns are kept in a ring
+// buffer, so the memory use is O(capacity), regardless of the number of
+// samples. Samples are best added in batches.
+//
+// Each column also gets a single value picked by the
+// largest-triangle-three-buckets (LTTB) method, for drawing the series as a
+// line. Classic LTTB considers every sample in the column; here, to keep
+// the memory bounded, only the extremes, and the first and the last
+// samples, are candidates (as in M4). The point with the largest triangle
+// area lies on the convex hull of the column's points, which those four
+// candidates approximate well for typical signals.
+class Decimator {
+ public:
+  // The capacity is the number of columns kept; at least 3.
+  Decimator(uint16_t capacity, uint32_t samples_per_column);
+
+  // Adds the samples, in order. NaN samples are skipped, but take up their
+  // place in the column.
+  void add(const float* samples, size_t count);
+
+  void add(float sample) { add(&sample, 1); }
+
+  // Removes all samples.
+  void clear();
+
+  uint16_t capacity() const { return capacity_; }
+  uint32_t samplesPerColumn() const { return samples_per_column_; }
+
+  // Total number of columns started (since construction, or clear()),
+  // including the one in progress, which is the last one.
+  uint32_t columnCount() const { return column_count_; }
+
+  // Returns the envelope of column n, which must be one of the last
+  // capacity() columns.
+  const ColumnEnvelope& column(uint32_t n) const {
+    return columns_[n % capacity_];
+  }
+
+  // The LTTB value of column n. It depends on the next column, so it is
+  // final only once the next column is complete; until then, it is the last
+  // sample of the column. Undefined if the column is empty.
+  float selected(uint32_t n) const { return column(n).selected; }
+
+ private:
+  ColumnEnvelope& mutableColumn(uint32_t n) { return columns_[n % capacity_]; }
+
+  // Starts a new, empty column.
+  void startColumn();
+
+  // Called when a column gets complete. Picks the LTTB value of the column
+  // before.
+  void completeColumn();
+
+  uint16_t capacity_;
+  uint32_t samples_per_column_;
+  std::unique_ptr<ColumnEnvelope[]> columns_;
+  uint32_t column_count_;
+};
+
+}  // namespace roo_dashboard
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "roo_display/color/color.h"
+#include "roo_display/color/gradient.h"
+
+namespace roo_dashboard {
+
+// A node of a gradient used to build a lookup table at compile time.
+struct GradientStop {
+  float value;
+  roo_display::Color color;
+};
+
+// Color lookup table, mapping values from the [min, max] range to colors by
+// picking the nearest of the evenly spaced, precomputed entries. Values
+// outside the range (and NaN) map to the color at the nearest end.
+//
+// Compared to roo_display::ColorGradient::getColor() (or an arbitrary
+// std::function), a lookup is a multiplication and an array access: no
+// virtual dispatch, and no search over the gradient nodes.
+//
+// This is the type accepted by the meters. It does not own the table; use
+// GradientLutTable to create one.
+class GradientLut {
+ public:
+  GradientLut(const GradientLut&) = delete;
+  GradientLut& operator=(const GradientLut&) = delete;
+
+  roo_display::Color getColor(float value) const {
+    if (!(value > min_)) return table_[0];
+    // Clamp before the conversion, which is undefined for out-of-range
+    // values.
+    float pos = (value - min_) * scale_ + 0.5f;
+    if (!(pos < size_)) return table_[size_ - 1];
+    return table_[(uint16_t)pos];
+  }
+
+  constexpr float min() const { return min_; }
+  constexpr float max() const { return max_; }
+  constexpr uint16_t size() const { return size_; }
+
+ protected:
+  constexpr GradientLut(const roo_display::Color* table, uint16_t size,
+                        float min, float max)
+      : table_(table),
+        size_(size),
+        min_(min),
+        max_(max),
+        scale_((size - 1) / (max - min)) {}
+
+ private:
+  const roo_display::Color* table_;
+  uint16_t size_;
+  float min_;
+  float max_;
+  float scale_;
+};
+
+namespace internal {
+
+constexpr uint8_t LerpChannel(uint8_t a, uint8_t b, float f) {
+  return (uint8_t)(a + (b - a) * f + 0.5f);
+}
+
+constexpr roo_display::Color InterpolateStops(const GradientStop* stops,
+                                              size_t count, float value) {
+  if (value <= stops[0].value) return stops[0].color;
+  for (size_t i = 1; i < count; ++i) {
+    if (value <= stops[i].value) {
+      const GradientStop& a = stops[i - 1];
+      const GradientStop& b = stops[i];
+      float f = (value - a.value) / (b.value - a.value);
+      return roo_display::Color(LerpChannel(a.color.r(), b.color.r(), f),
+                                LerpChannel(a.color.g(), b.color.g(), f),
+                                LerpChannel(a.color.b(), b.color.b(), f),
+                                LerpChannel(a.color.a(), b.color.a(), f));
+    }
+  }
+  return stops[count - 1].color;
+}
+
+}  // namespace internal
+
+// A GradientLut with N entries, stored inline (4 * N bytes).
+//
+// Can be built at compile time from a list of stops:
+//
+//   static constexpr GradientStop kStops[] = {
+//       {0.0, color::Blue}, {20.0, color::Green}, {40.0, color::Red}};
+//   static constexpr GradientLutTable<64> kLut(kStops, 0.0, 40.0);
+//
+// or at run time, from a roo_display::ColorGradient.
+template <uint16_t N>
+class GradientLutTable : public GradientLut {
+ public:
+  static_assert(N >= 2, "The table needs at least 2 entries");
+
+  template <size_t S>
+  constexpr GradientLutTable(const GradientStop (&stops)[S], float min,
+                             float max)
+      : GradientLut(colors_, N, min, max), colors_{} {
+    for (uint16_t i = 0; i < N; ++i) {
+      colors_[i] = internal::InterpolateStops(stops, S,
+                                              min + (max - min) * i / (N - 1));
+    }
+  }
+
+  GradientLutTable(const roo_display::ColorGradient& gradient, float min,
+                   float max)
+      : GradientLut(colors_, N, min, max) {
+    for (uint16_t i = 0; i < N; ++i) {
+      colors_[i] = gradient.getColor(min + (max - min) * i / (N - 1));
+    }
+  }
+
+ private:
+  roo_display::Color colors_[N];
+};
+
+}  // namespace roo_dashboard
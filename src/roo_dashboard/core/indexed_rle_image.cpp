@@ -0,0 +1,232 @@
+#include "roo_dashboard/core/indexed_rle_image.h"
+
+#include <algorithm>
+
+#include "roo_display.h"
+
+using namespace roo_display;
+
+namespace roo_dashboard {
+
+namespace {
+
+// Decoder of the 4bpp 'biased' RLE stream, which can start at any code.
+//
+// Note: the data lives in PROGMEM, which is memory-mapped on the supported
+// (32-bit) platforms, so it is read directly.
+class Decoder {
+ public:
+  Decoder(const uint8_t* data, uint32_t nibble_offset)
+      : data_(data),
+        pos_(nibble_offset),
+        remaining_(0),
+        literal_(false),
+        value_(0) {}
+
+  // Returns the next pixel value (0-15).
+  uint8_t next() {
+    if (remaining_ == 0) readCode();
+    --remaining_;
+    return literal_ ? nibble() : value_;
+  }
+
+  void skip(uint32_t count) {
+    while (count > 0) {
+      if (remaining_ == 0) readCode();
+      uint32_t n = std::min(count, remaining_);
+      if (literal_) pos_ += n;
+      remaining_ -= n;
+      count -= n;
+    }
+  }
+
+ private:
+  uint8_t nibble() {
+    uint8_t b = data_[pos_ >> 1];
+    return (pos_++ & 1) ? (b & 0x0F) : (b >> 4);
+  }
+
+  // Big-endian, 3 bits per nibble; the high bit means 'continued'.
+  uint32_t varint() {
+    uint32_t result = 0;
+    while (true) {
+      uint8_t n = nibble();
+      result = (result << 3) | (n & 0x07);
+      if ((n & 0x08) == 0) return result;
+    }
+  }
+
+  void readCode() {
+    uint8_t n = nibble();
+    literal_ = false;
+    if (n == 0) {
+      // A single literal pixel, or a pair.
+      value_ = nibble();
+      if (value_ != 0) {
+        remaining_ = 1;
+      } else {
+        value_ = nibble();
+        remaining_ = 2;
+      }
+    } else if (n < 8) {
+      value_ = 0;
+      remaining_ = n;
+    } else if (n > 8) {
+      value_ = 15;
+      remaining_ = n - 8;
+    } else {
+      uint32_t count = varint();
+      if (count == 0) {
+        remaining_ = varint() + 4;
+        value_ = nibble();
+      } else {
+        remaining_ = count + 2;
+        literal_ = true;
+      }
+    }
+  }
+
+  const uint8_t* data_;
+  uint32_t pos_;
+  uint32_t remaining_;
+  bool literal_;
+  uint8_t value_;
+};
+
+// Accumulates horizontal segments of pixels, and writes them to the output.
+class SegmentWriter {
+ public:
+  SegmentWriter(DisplayOutput& out, BlendingMode mode)
+      : out_(out), mode_(mode), x_(0), y_(0), count_(0) {}
+
+  ~SegmentWriter() { flush(); }
+
+  void write(int16_t x, int16_t y, Color color) {
+    if (count_ > 0 && (y != y_ || x != x_ + count_ || count_ == kBufSize)) {
+      flush();
+    }
+    if (count_ == 0) {
+      x_ = x;
+      y_ = y;
+    }
+    buf_[count_++] = color;
+  }
+
+  void flush() {
+    if (count_ == 0) return;
+    out_.setAddress(x_, y_, x_ + count_ - 1, y_, mode_);
+    out_.write(buf_, count_);
+    count_ = 0;
+  }
+
+ private:
+  static constexpr int16_t kBufSize = 64;
+
+  DisplayOutput& out_;
+  BlendingMode mode_;
+  int16_t x_;
+  int16_t y_;
+  int16_t count_;
+  Color buf_[kBufSize];
+};
+
+// Writes consecutive pixels of a single address window, in chunks.
+class StreamWriter {
+ public:
+  StreamWriter(DisplayOutput& out, BlendingMode mode, const Box& window)
+      : out_(out), count_(0) {
+    out_.setAddress(window.xMin(), window.yMin(), window.xMax(), window.yMax(),
+                    mode);
+  }
+
+  ~StreamWriter() { flush(); }
+
+  void write(int16_t x, int16_t y, Color color) {
+    if (count_ == kBufSize) flush();
+    buf_[count_++] = color;
+  }
+
+  void flush() {
+    if (count_ == 0) return;
+    out_.write(buf_, count_);
+    count_ = 0;
+  }
+
+ private:
+  static constexpr int16_t kBufSize = 64;
+
+  DisplayOutput& out_;
+  int16_t count_;
+  Color buf_[kBufSize];
+};
+
+template <typename Writer>
+void DrawRows(Decoder& decoder, const Color* palette,
+              const RleImageOverlay* overlay, bool skip_transparent,
+              int16_t width, int16_t row_first, int16_t row_last,
+              int16_t col_first, int16_t col_last, int16_t x_offset,
+              int16_t y_offset, Writer& writer) {
+  for (int16_t row = row_first; row <= row_last; ++row) {
+    int16_t span_min = 0;
+    int16_t span_max = -1;
+    Color span_color;
+    if (overlay != nullptr) {
+      overlay->getSpan(row, span_min, span_max, span_color);
+    }
+    decoder.skip(col_first);
+    for (int16_t col = col_first; col <= col_last; ++col) {
+      uint8_t v = decoder.next();
+      if (col >= span_min && col <= span_max) {
+        writer.write(col + x_offset, row + y_offset, span_color);
+        continue;
+      }
+      if (v == 0 && skip_transparent) continue;
+      writer.write(col + x_offset, row + y_offset, palette[v]);
+    }
+    if (row < row_last) decoder.skip(width - 1 - col_last);
+  }
+}
+
+}  // namespace
+
+void IndexedRleImage4bppxBiased::drawTo(const Surface& s) const {
+  int16_t x_offset = extents_.xMin() + s.dx();
+  int16_t y_offset = extents_.yMin() + s.dy();
+  Box bounds = Box::Intersect(s.clip_box(),
+                              extents_.translate(s.dx(), s.dy()));
+  if (bounds.empty()) return;
+
+  // Visible range, in image coordinates.
+  int16_t width = extents_.width();
+  int16_t row_first = bounds.yMin() - y_offset;
+  int16_t row_last = bounds.yMax() - y_offset;
+  int16_t col_first = bounds.xMin() - x_offset;
+  int16_t col_last = bounds.xMax() - x_offset;
+
+  uint16_t entry = std::min<uint16_t>(row_first / index_.rows_per_entry,
+                                      index_.entry_count - 1);
+  Decoder decoder(data_, index_.entries[2 * entry]);
+  decoder.skip(index_.entries[2 * entry + 1] +
+               (uint32_t)(row_first - entry * index_.rows_per_entry) * width);
+
+  // All pixels have the same color, differing in alpha only.
+  Color palette[16];
+  for (int i = 0; i < 16; ++i) {
+    uint32_t argb = (uint32_t)(i * 0x11) << 24 | (color_.asArgb() & 0xFFFFFF);
+    palette[i] = AlphaBlend(s.bgcolor(), Color(argb));
+  }
+  bool skip_transparent = (s.fill_mode() == FillMode::kVisible);
+
+  if (skip_transparent) {
+    SegmentWriter writer(s.out(), s.blending_mode());
+    DrawRows(decoder, palette, overlay_, true, width, row_first, row_last,
+             col_first, col_last, x_offset, y_offset, writer);
+  } else {
+    // Every pixel gets written, so the whole area can be streamed.
+    StreamWriter writer(s.out(), s.blending_mode(), bounds);
+    DrawRows(decoder, palette, overlay_, false, width, row_first, row_last,
+             col_first, col_last, x_offset, y_offset, writer);
+  }
+}
+
+}  // namespace roo_dashboard
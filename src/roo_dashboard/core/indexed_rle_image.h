@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+#include "roo_display/color/color.h"
+#include "roo_display/core/box.h"
+#include "roo_display/core/drawable.h"
+
+namespace roo_dashboard {
+
+// Row index of a 4bpp 'biased' RLE image stream (as used by
+// roo_display::RleImage4bppxBiased). Generated, along with the image
+// resource, by tools/rle_row_index.py.
+struct RleRowIndex {
+  // Number of rows between consecutive entries.
+  uint8_t rows_per_entry;
+
+  uint16_t entry_count;
+
+  // Pairs of uint16_t, one pair for every rows_per_entry rows: the offset (in
+  // nibbles) of the code that covers the first pixel of the row, and the
+  // number of pixels of that code that belong to the preceding rows. Stored
+  // in PROGMEM.
+  const uint16_t* entries;
+};
+
+// Opaque horizontal spans, painted over an IndexedRleImage4bppxBiased in the
+// same pass as the image itself (rather than as separate draw calls, each
+// with its own address window). At most one span per row.
+class RleImageOverlay {
+ public:
+  virtual ~RleImageOverlay() = default;
+
+  // If the row (in image coordinates) has a span, sets its (inclusive) column
+  // range and color, and returns true. Otherwise, returns false.
+  virtual bool getSpan(int16_t row, int16_t& col_min, int16_t& col_max,
+                       roo_display::Color& color) const = 0;
+};
+
+// Draws the same image as RleImage4bppxBiased<Alpha4, ProgMemPtr>, but uses
+// the row index to start decoding near the first visible row, and stops after
+// the last visible row. That way, the cost of a clipped draw is proportional
+// to the number of visible rows, rather than to the position of the clip box
+// within the image.
+//
+// When drawn with FillMode::kExtents, the visible area is written as a single
+// address window, streamed row by row.
+class IndexedRleImage4bppxBiased : public roo_display::Drawable {
+ public:
+  // The overlay, if specified, must outlive the image.
+  IndexedRleImage4bppxBiased(roo_display::Box extents, const uint8_t* data,
+                             const RleRowIndex& index, roo_display::Color color,
+                             const RleImageOverlay* overlay = nullptr)
+      : extents_(extents),
+        data_(data),
+        index_(index),
+        color_(color),
+        overlay_(overlay) {}
+
+  roo_display::Box extents() const override { return extents_; }
+
+ private:
+  void drawTo(const roo_display::Surface& s) const override;
+
+  roo_display::Box extents_;
+  const uint8_t* data_;
+  const RleRowIndex& index_;
+
+  // Color of the fully opaque pixels.
+  roo_display::Color color_;
+
+  const RleImageOverlay* overlay_;
+};
+
+}  // namespace roo_dashboard
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "roo_display/color/color.h"
+#include "roo_display/core/box.h"
+#include "roo_display/core/rasterizable.h"
+#include "roo_windows/core/canvas.h"
+#include "roo_windows/core/rect.h"
+
+namespace roo_dashboard {
+
+// A range of positions along the axis of a linear meter, in pixels from its
+// start (inclusive on both ends). Empty if max < min.
+struct LinearSpan {
+  int16_t min;
+  int16_t max;
+
+  bool empty() const { return max < min; }
+};
+
+// Up to two disjoint spans (e.g., on both sides of the zero line), in
+// increasing order. Either may be empty.
+struct LinearSpanPair {
+  LinearSpan first;
+  LinearSpan second;
+};
+
+// Orientations of a linear meter. Map spans along the axis to rectangles
+// within the widget of the given dimensions.
+
+// Grows from left to right.
+struct HorizontalOrientation {
+  static int16_t Length(int16_t width, int16_t height) { return width; }
+
+  static roo_windows::Rect ToRect(LinearSpan span, int16_t width,
+                                  int16_t height) {
+    return roo_windows::Rect(span.min, 0, span.max, height - 1);
+  }
+};
+
+// Grows from bottom to top.
+struct VerticalOrientation {
+  static int16_t Length(int16_t width, int16_t height) { return height; }
+
+  static roo_windows::Rect ToRect(LinearSpan span, int16_t width,
+                                  int16_t height) {
+    return roo_windows::Rect(0, height - 1 - span.max, width - 1,
+                             height - 1 - span.min);
+  }
+};
+
+// State of a linear meter: a bar filled from the zero position (exclusive)
+// to the end position (inclusive), in either direction, with a one-pixel
+// zero line at the zero position. The rest is empty. For a bar that starts
+// at the edge, with no zero line, use zero = -1.
+//
+// Keeps track of the state as of the last paint, so that only the spans that
+// changed get repainted: between the old and the new end if only the end
+// moved, or also the rest of the filled area if the color changed.
+template <typename Orientation>
+class LinearMeter {
+ public:
+  explicit LinearMeter(int16_t zero)
+      : zero_(zero),
+        end_(zero),
+        color_(roo_display::color::Transparent),
+        clean_end_(zero),
+        clean_color_(roo_display::color::Transparent) {}
+
+  int16_t zero() const { return zero_; }
+  int16_t end() const { return end_; }
+  roo_display::Color color() const { return color_; }
+
+  // Returns true if the state has changed.
+  bool set(int16_t end, roo_display::Color color) {
+    if (end == end_ && color == color_) return false;
+    end_ = end;
+    color_ = color;
+    return true;
+  }
+
+  // The spans that changed since the last call to markClean().
+  LinearSpanPair dirtySpans() const {
+    return ChangedSpans(zero_, clean_end_, end_, clean_color_ != color_);
+  }
+
+  // Call after the dirty spans have been painted (or invalidated).
+  void markClean() {
+    clean_end_ = end_;
+    clean_color_ = color_;
+  }
+
+  // Returns the spans that need to be repainted when the end moves from
+  // old_end to new_end: the pixels between the ends, on either side of the
+  // zero line (which itself does not change). If the color changed, the
+  // (single) span also covers all of the old and the new filled area.
+  static LinearSpanPair ChangedSpans(int16_t zero, int16_t old_end,
+                                     int16_t new_end, bool color_changed) {
+    static constexpr LinearSpan kEmpty{0, -1};
+    if (color_changed) {
+      return LinearSpanPair{LinearSpan{std::min({zero, old_end, new_end}),
+                                       std::max({zero, old_end, new_end})},
+                            kEmpty};
+    }
+    int16_t low = std::min(old_end, new_end);
+    int16_t high = std::max(old_end, new_end);
+    if (low >= zero) {
+      // Filled in (zero, end].
+      return LinearSpanPair{LinearSpan{(int16_t)(low + 1), high}, kEmpty};
+    }
+    if (high <= zero) {
+      // Filled in [end, zero).
+      return LinearSpanPair{LinearSpan{low, (int16_t)(high - 1)}, kEmpty};
+    }
+    // Crossed the zero line.
+    return LinearSpanPair{LinearSpan{low, (int16_t)(zero - 1)},
+                          LinearSpan{(int16_t)(zero + 1), high}};
+  }
+
+  // Paints the part of the meter within the dirty spans (or, if full, all of
+  // it) on the canvas of a widget with the given dimensions. The empty area
+  // is cleared to the background.
+  void paint(const roo_windows::Canvas& canvas, bool full, int16_t width,
+             int16_t height, roo_display::Color zero_line_color) const {
+    int16_t length = Orientation::Length(width, height);
+    if (full) {
+      paintSpan(canvas, LinearSpan{0, (int16_t)(length - 1)}, width, height,
+                zero_line_color);
+      return;
+    }
+    LinearSpanPair spans = dirtySpans();
+    paintSpan(canvas, spans.first, width, height, zero_line_color);
+    paintSpan(canvas, spans.second, width, height, zero_line_color);
+  }
+
+ private:
+  void paintSpan(const roo_windows::Canvas& canvas, LinearSpan span,
+                 int16_t width, int16_t height,
+                 roo_display::Color zero_line_color) const {
+    if (span.empty()) return;
+    roo_windows::Canvas my_canvas = canvas;
+    my_canvas.clipToExtents(Orientation::ToRect(span, width, height));
+    if (my_canvas.clip_box().empty()) return;
+    int16_t length = Orientation::Length(width, height);
+    roo_display::Color bg = canvas.bgcolor();
+    roo_display::Color fill = roo_display::AlphaBlend(bg, color_);
+    int16_t low = std::min(end_, zero_);
+    int16_t high = std::max(end_, zero_);
+    clear(my_canvas, LinearSpan{0, (int16_t)(low - 1)}, width, height);
+    if (end_ < zero_) {
+      fillSpan(my_canvas, LinearSpan{end_, (int16_t)(zero_ - 1)}, width,
+               height, fill);
+    }
+    if (zero_ >= 0) {
+      fillSpan(my_canvas, LinearSpan{zero_, zero_}, width, height,
+               roo_display::AlphaBlend(bg, zero_line_color));
+    }
+    if (end_ > zero_) {
+      fillSpan(my_canvas, LinearSpan{(int16_t)(zero_ + 1), end_}, width,
+               height, fill);
+    }
+    clear(my_canvas, LinearSpan{(int16_t)(high + 1), (int16_t)(length - 1)},
+          width, height);
+  }
+
+  static void fillSpan(const roo_windows::Canvas& canvas, LinearSpan span,
+                       int16_t width, int16_t height,
+                       roo_display::Color color) {
+    if (span.empty()) return;
+    canvas.fillRect(Orientation::ToRect(span, width, height), color);
+  }
+
+  static void clear(const roo_windows::Canvas& canvas, LinearSpan span,
+                    int16_t width, int16_t height) {
+    if (span.empty()) return;
+    canvas.clearRect(Orientation::ToRect(span, width, height));
+  }
+
+  int16_t zero_;
+  int16_t end_;
+  roo_display::Color color_;
+
+  // As of the last markClean().
+  int16_t clean_end_;
+  roo_display::Color clean_color_;
+};
+
+// Rasterizable two-color fill of a linear meter with zero = -1: 'fill' up to
+// and including the end, and 'empty' past it. Useful as a background of
+// widgets drawn over the meter (e.g., a label). Rectangles are filled in
+// uniform spans, split at the end.
+template <typename Orientation>
+class LinearMeterRaster : public roo_display::Rasterizable {
+ public:
+  // The extents are in device coordinates; the end is relative to the start
+  // of the meter.
+  LinearMeterRaster(roo_display::Box extents, int16_t end,
+                    roo_display::Color fill, roo_display::Color empty);
+
+  void readColors(const int16_t* x, const int16_t* y, uint32_t count,
+                  roo_display::Color* result) const override;
+
+  bool readColorRect(int16_t xMin, int16_t yMin, int16_t xMax, int16_t yMax,
+                     roo_display::Color* result) const override;
+
+  roo_display::Box extents() const override { return extents_; }
+
+ private:
+  roo_display::Box extents_;
+  roo_display::Color fill_;
+  roo_display::Color empty_;
+
+  // The first device coordinate (x or y) past the end of the fill.
+  int16_t threshold_;
+};
+
+template <>
+inline LinearMeterRaster<HorizontalOrientation>::LinearMeterRaster(
+    roo_display::Box extents, int16_t end, roo_display::Color fill,
+    roo_display::Color empty)
+    : extents_(extents),
+      fill_(fill),
+      empty_(empty),
+      threshold_(extents.xMin() + end + 1) {}
+
+template <>
+inline LinearMeterRaster<VerticalOrientation>::LinearMeterRaster(
+    roo_display::Box extents, int16_t end, roo_display::Color fill,
+    roo_display::Color empty)
+    : extents_(extents),
+      fill_(fill),
+      empty_(empty),
+      threshold_(extents.yMax() - end - 1) {}
+
+// Horizontal: filled where x < threshold_.
+
+template <>
+inline void LinearMeterRaster<HorizontalOrientation>::readColors(
+    const int16_t* x, const int16_t* y, uint32_t count,
+    roo_display::Color* result) const {
+  // Branch-free: the comparison selects the color.
+  const roo_display::Color colors[] = {fill_, empty_};
+  while (count-- > 0) *result++ = colors[*x++ >= threshold_];
+}
+
+template <>
+inline bool LinearMeterRaster<HorizontalOrientation>::readColorRect(
+    int16_t xMin, int16_t yMin, int16_t xMax, int16_t yMax,
+    roo_display::Color* result) const {
+  if (xMax < threshold_) {
+    *result = fill_;
+    return true;
+  }
+  if (xMin >= threshold_) {
+    *result = empty_;
+    return true;
+  }
+  // The rectangle straddles the threshold. All rows are the same: two
+  // uniform spans, split at the threshold.
+  uint32_t width = xMax - xMin + 1;
+  uint32_t split = threshold_ - xMin;
+  std::fill_n(result, split, fill_);
+  std::fill_n(result + split, width - split, empty_);
+  for (int16_t y = yMin + 1; y <= yMax; ++y) {
+    std::copy_n(result, width, result + width * (y - yMin));
+  }
+  return false;
+}
+
+// Vertical: filled where y > threshold_.
+
+template <>
+inline void LinearMeterRaster<VerticalOrientation>::readColors(
+    const int16_t* x, const int16_t* y, uint32_t count,
+    roo_display::Color* result) const {
+  const roo_display::Color colors[] = {empty_, fill_};
+  while (count-- > 0) *result++ = colors[*y++ > threshold_];
+}
+
+template <>
+inline bool LinearMeterRaster<VerticalOrientation>::readColorRect(
+    int16_t xMin, int16_t yMin, int16_t xMax, int16_t yMax,
+    roo_display::Color* result) const {
+  if (yMin > threshold_) {
+    *result = fill_;
+    return true;
+  }
+  if (yMax <= threshold_) {
+    *result = empty_;
+    return true;
+  }
+  // Rows are uniform: empty down to the threshold, filled below.
+  uint32_t width = xMax - xMin + 1;
+  uint32_t split = (threshold_ - yMin + 1) * width;
+  uint32_t count = (yMax - yMin + 1) * width;
+  std::fill_n(result, split, empty_);
+  std::fill_n(result + split, count - split, fill_);
+  return false;
+}
+
+}  // namespace roo_dashboard
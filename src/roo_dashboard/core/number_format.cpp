@@ -0,0 +1,136 @@
+#include "roo_dashboard/core/number_format.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace roo_dashboard {
+
+namespace {
+
+constexpr uint8_t kMaxPrecision = 6;
+
+constexpr uint32_t kPowersOf10[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+// Copies the literal text between begin and end, unescaping '%%'. Returns
+// false if it does not fit, or if it contains a lone '%'.
+bool CopyLiteral(const char* begin, const char* end, char* out,
+                 size_t capacity) {
+  size_t size = 0;
+  while (begin < end) {
+    if (*begin == '%') {
+      if (begin + 1 >= end || begin[1] != '%') return false;
+      ++begin;
+    }
+    if (size + 1 >= capacity) return false;
+    out[size++] = *begin++;
+  }
+  out[size] = '\0';
+  return true;
+}
+
+// Appends the string, as much as fits.
+void Append(const char* s, char* buf, uint8_t& size, uint8_t capacity) {
+  while (*s != '\0' && size + 1 < capacity) buf[size++] = *s++;
+}
+
+}  // namespace
+
+bool NumberFormat::Parse(const char* printf_template, NumberFormat& result) {
+  result = NumberFormat();
+  // Find the conversion, skipping over '%%'.
+  const char* p = printf_template;
+  while (true) {
+    p = strchr(p, '%');
+    if (p == nullptr) return false;
+    if (p[1] != '%') break;
+    p += 2;
+  }
+  if (!CopyLiteral(printf_template, p, result.prefix, sizeof(result.prefix))) {
+    return false;
+  }
+  ++p;
+  for (; *p == '+' || *p == ' '; ++p) {
+    if (*p == '+') result.force_sign = true;
+  }
+  int width = 0;
+  for (; *p >= '0' && *p <= '9'; ++p) width = width * 10 + (*p - '0');
+  if (width > 16) return false;
+  result.width = width;
+  if (*p == '.') {
+    ++p;
+    int precision = 0;
+    for (; *p >= '0' && *p <= '9'; ++p) precision = precision * 10 + (*p - '0');
+    if (precision > kMaxPrecision) return false;
+    result.precision = precision;
+  } else {
+    // Same default as printf.
+    result.precision = 6;
+  }
+  if (*p != 'f' && *p != 'F') return false;
+  ++p;
+  return CopyLiteral(p, p + strlen(p), result.suffix, sizeof(result.suffix));
+}
+
+FormattedNumber::FormattedNumber(float value, const NumberFormat& format)
+    : size_(0) {
+  Append(format.prefix, buf_, size_, kCapacity);
+
+  // The number, right to left.
+  char digits[20];
+  uint8_t count = 0;
+  uint8_t precision = format.precision > kMaxPrecision ? kMaxPrecision
+                                                        : format.precision;
+  bool negative = false;
+  if (std::isnan(value)) {
+    memcpy(digits, "nan", 3);
+    count = 3;
+  } else {
+    float magnitude = fabsf(value);
+    if (!(magnitude < 4e9f)) {
+      memcpy(digits, "fvo", 3);
+      count = 3;
+    } else {
+      // The integer part is exact, and so is the remaining fraction. The
+      // fraction has at most 24 significant bits, and 10^6 needs 14 more, so
+      // scaling it in double is exact too. This way, we round the exact
+      // binary value, as printf does; in float, the rounding error of the
+      // scaling would create false ties (e.g. 0.35f would round up).
+      uint32_t integer = (uint32_t)magnitude;
+      double scaled = (double)(magnitude - integer) * kPowersOf10[precision];
+      uint32_t fraction = (uint32_t)scaled;
+      double remainder = scaled - fraction;
+      // Round half to even, as printf does. The last digit shown is in the
+      // integer part if the precision is zero.
+      uint32_t last = (precision > 0) ? fraction : integer;
+      if (remainder > 0.5 || (remainder == 0.5 && (last & 1) != 0)) {
+        ++fraction;
+      }
+      if (fraction >= kPowersOf10[precision]) {
+        fraction = 0;
+        ++integer;
+      }
+      // Don't print "-0.0".
+      negative = (value < 0 && (integer != 0 || fraction != 0));
+      for (uint8_t i = 0; i < precision; ++i) {
+        digits[count++] = '0' + fraction % 10;
+        fraction /= 10;
+      }
+      if (precision > 0) digits[count++] = '.';
+      do {
+        digits[count++] = '0' + integer % 10;
+        integer /= 10;
+      } while (integer > 0);
+    }
+  }
+  char sign = negative ? '-' : (format.force_sign ? '+' : '\0');
+  if (sign != '\0') digits[count++] = sign;
+  for (uint8_t i = count; i < format.width && size_ + 1 < kCapacity; ++i) {
+    buf_[size_++] = ' ';
+  }
+  while (count > 0 && size_ + 1 < kCapacity) buf_[size_++] = digits[--count];
+
+  Append(format.suffix, buf_, size_, kCapacity);
+  buf_[size_] = '\0';
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+namespace roo_dashboard {
+
+// Fixed-point format of a number in a caption, e.g. "+12.5°C": an optional
+// prefix, the number (with a sign, padded on the left to the minimum width),
+// and an optional suffix (typically, the unit).
+//
+// Formatting (see FormattedNumber) writes into an inline buffer, with no
+// varargs and no heap allocations.
+struct NumberFormat {
+  // Digits after the decimal point (0-6).
+  uint8_t precision = 1;
+
+  // Minimum width of the number (including the sign), padded with spaces.
+  uint8_t width = 0;
+
+  // Whether to print '+' for positive numbers.
+  bool force_sign = false;
+
+  char prefix[8] = "";
+  char suffix[8] = "";
+
+  // Parses a printf-style template, with a single floating-point conversion,
+  // e.g. "%.1f%%" or "T: %+5.1f°C". Supported flags are '+' and ' ', followed
+  // by optional width and precision. Returns false if the template is not of
+  // this form, or if the prefix or the suffix are too long; the result is
+  // then unspecified.
+  static bool Parse(const char* printf_template, NumberFormat& result);
+};
+
+// A number formatted according to NumberFormat. Rounds like printf, except
+// that it never shows negative zero. Numbers whose magnitude exceeds 4e9 are
+// shown as "ovf"; NaN is shown as "nan".
+class FormattedNumber {
+ public:
+  FormattedNumber(float value, const NumberFormat& format);
+
+  const char* c_str() const { return buf_; }
+  uint8_t size() const { return size_; }
+
+ private:
+  // Fits the prefix, the suffix, and a 10-digit number with a sign and a
+  // decimal point.
+  static constexpr uint8_t kCapacity = 32;
+
+  char buf_[kCapacity];
+  uint8_t size_;
+};
+
+}  // namespace roo_dashboard
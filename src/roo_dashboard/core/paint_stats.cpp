@@ -0,0 +1,109 @@
+#include "roo_dashboard/core/paint_stats.h"
+
+#if ROO_DASHBOARD_PAINT_STATS
+
+#include "roo_logging.h"
+
+namespace roo_dashboard {
+
+namespace {
+
+// The entries of the widgets that have painted, and that are still alive.
+internal::PaintStatsEntry* head = nullptr;
+
+}  // namespace
+
+const PaintStats* GetPaintStats(const roo_windows::Widget& widget) {
+  for (const internal::PaintStatsEntry* entry = head; entry != nullptr;
+       entry = entry->next()) {
+    if (&entry->widget() == &widget) return &entry->stats();
+  }
+  return nullptr;
+}
+
+void ResetPaintStats() {
+  for (internal::PaintStatsEntry* entry = head; entry != nullptr;
+       entry = entry->next()) {
+    entry->reset();
+  }
+}
+
+void DumpPaintStats() {
+  LOG(INFO) << "Paint stats: widget, paints (full/incremental), pixels, us, "
+               "us/paint";
+  for (const internal::PaintStatsEntry* entry = head; entry != nullptr;
+       entry = entry->next()) {
+    const PaintStats& s = entry->stats();
+    LOG(INFO) << entry->name() << "@" << (const void*)&entry->widget() << ": "
+              << s.paints << " (" << s.full_paints << "/"
+              << s.incremental_paints << "), " << s.pixels << " px, "
+              << s.micros << " us, "
+              << (s.paints == 0 ? 0 : s.micros / s.paints) << " us/paint";
+  }
+}
+
+namespace internal {
+
+PaintStatsEntry::~PaintStatsEntry() {
+  if (!linked_) return;
+  if (prev_ != nullptr) {
+    prev_->next_ = next_;
+  } else {
+    head = next_;
+  }
+  if (next_ != nullptr) next_->prev_ = prev_;
+}
+
+void PaintStatsEntry::record(const char* name, bool invalidated,
+                             uint64_t pixels, uint64_t micros) {
+  if (!linked_) {
+    next_ = head;
+    if (head != nullptr) head->prev_ = this;
+    head = this;
+    linked_ = true;
+  }
+  name_ = name;
+  ++stats_.paints;
+  if (invalidated) {
+    ++stats_.full_paints;
+  } else {
+    ++stats_.incremental_paints;
+  }
+  stats_.pixels += pixels;
+  stats_.micros += micros;
+}
+
+uint64_t PixelCounter::area(const int16_t* x0, const int16_t* y0,
+                            const int16_t* x1, const int16_t* y1,
+                            uint16_t count) {
+  uint64_t total = 0;
+  for (uint16_t i = 0; i < count; ++i) {
+    total += (uint64_t)(x1[i] - x0[i] + 1) * (y1[i] - y0[i] + 1);
+  }
+  return total;
+}
+
+PaintStatsScope::PaintStatsScope(PaintStatsEntry& entry, const char* name,
+                                 bool dirty, bool invalidated,
+                                 const roo_windows::Canvas& canvas)
+    : entry_(entry),
+      name_(name),
+      dirty_(dirty),
+      invalidated_(invalidated),
+      counter_(canvas.out()),
+      canvas_(canvas),
+      start_(roo_time::Uptime::Now()) {
+  canvas_.set_out(&counter_);
+}
+
+PaintStatsScope::~PaintStatsScope() {
+  if (!dirty_) return;
+  uint64_t micros = (roo_time::Uptime::Now() - start_).inMicros();
+  entry_.record(name_, invalidated_, counter_.pixels(), micros);
+}
+
+}  // namespace internal
+
+}  // namespace roo_dashboard
+
+#endif  // ROO_DASHBOARD_PAINT_STATS
@@ -0,0 +1,198 @@
+#pragma once
+
+// Optional paint instrumentation of the dashboard widgets.
+//
+// When compiled with ROO_DASHBOARD_PAINT_STATS=1, each widget records how many
+// times it painted (and whether the paint was full or incremental), how many
+// pixels it wrote, and how much time it took. The stats can be queried per
+// widget, or dumped to the log (i.e. serial) to find out which widgets eat
+// the frame budget.
+//
+// When disabled (the default), the instrumentation compiles to nothing.
+
+#include <cstdint>
+
+#ifndef ROO_DASHBOARD_PAINT_STATS
+#define ROO_DASHBOARD_PAINT_STATS 0
+#endif
+
+#if ROO_DASHBOARD_PAINT_STATS
+#include "roo_display/core/device.h"
+#include "roo_time.h"
+#endif
+
+#include "roo_windows/core/canvas.h"
+#include "roo_windows/core/widget.h"
+
+namespace roo_dashboard {
+
+struct PaintStats {
+  // Number of times the widget painted anything.
+  uint32_t paints;
+
+  // Paints of the entire widget, after it has been invalidated (e.g. on page
+  // switch, or after a layout change).
+  uint32_t full_paints;
+
+  // Paints of the parts that changed (e.g. after a value update).
+  uint32_t incremental_paints;
+
+  // Number of pixels written to the display.
+  uint64_t pixels;
+
+  // Total time spent painting, in microseconds.
+  uint64_t micros;
+};
+
+#if ROO_DASHBOARD_PAINT_STATS
+
+// Returns the stats of the specified widget, or nullptr if it has not painted
+// yet.
+const PaintStats* GetPaintStats(const roo_windows::Widget& widget);
+
+// Resets the stats of all widgets.
+void ResetPaintStats();
+
+// Writes the stats of all widgets to the log, one line per widget.
+void DumpPaintStats();
+
+namespace internal {
+
+// The paint stats of a single widget, held by the widget itself (see
+// ROO_DASHBOARD_PAINT_STATS_MEMBER). Once the widget paints, the entry links
+// itself into a global list, so that the stats of all live widgets can be
+// reset or dumped; the destructor unlinks it.
+class PaintStatsEntry {
+ public:
+  PaintStatsEntry(const roo_windows::Widget& widget)
+      : widget_(widget),
+        name_(nullptr),
+        stats_{},
+        linked_(false),
+        prev_(nullptr),
+        next_(nullptr) {}
+
+  PaintStatsEntry(const PaintStatsEntry&) = delete;
+  PaintStatsEntry& operator=(const PaintStatsEntry&) = delete;
+
+  ~PaintStatsEntry();
+
+  const roo_windows::Widget& widget() const { return widget_; }
+  const char* name() const { return name_; }
+  const PaintStats& stats() const { return stats_; }
+
+  // Returns nullptr if the entry is the last one.
+  const PaintStatsEntry* next() const { return next_; }
+  PaintStatsEntry* next() { return next_; }
+
+  void record(const char* name, bool invalidated, uint64_t pixels,
+              uint64_t micros);
+
+  void reset() { stats_ = PaintStats{}; }
+
+ private:
+  const roo_windows::Widget& widget_;
+  const char* name_;
+  PaintStats stats_;
+  bool linked_;
+  PaintStatsEntry* prev_;
+  PaintStatsEntry* next_;
+};
+
+// Display output filter that counts the pixels written.
+class PixelCounter : public roo_display::DisplayOutput {
+ public:
+  PixelCounter(roo_display::DisplayOutput& delegate)
+      : delegate_(delegate), pixels_(0) {}
+
+  void setAddress(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                  roo_display::BlendingMode mode) override {
+    delegate_.setAddress(x0, y0, x1, y1, mode);
+  }
+
+  void write(roo_display::Color* color, uint32_t pixel_count) override {
+    pixels_ += pixel_count;
+    delegate_.write(color, pixel_count);
+  }
+
+  void writePixels(roo_display::BlendingMode mode, roo_display::Color* color,
+                   int16_t* x, int16_t* y, uint16_t pixel_count) override {
+    pixels_ += pixel_count;
+    delegate_.writePixels(mode, color, x, y, pixel_count);
+  }
+
+  void fillPixels(roo_display::BlendingMode mode, roo_display::Color color,
+                  int16_t* x, int16_t* y, uint16_t pixel_count) override {
+    pixels_ += pixel_count;
+    delegate_.fillPixels(mode, color, x, y, pixel_count);
+  }
+
+  void writeRects(roo_display::BlendingMode mode, roo_display::Color* color,
+                  int16_t* x0, int16_t* y0, int16_t* x1, int16_t* y1,
+                  uint16_t count) override {
+    pixels_ += area(x0, y0, x1, y1, count);
+    delegate_.writeRects(mode, color, x0, y0, x1, y1, count);
+  }
+
+  void fillRects(roo_display::BlendingMode mode, roo_display::Color color,
+                 int16_t* x0, int16_t* y0, int16_t* x1, int16_t* y1,
+                 uint16_t count) override {
+    pixels_ += area(x0, y0, x1, y1, count);
+    delegate_.fillRects(mode, color, x0, y0, x1, y1, count);
+  }
+
+  uint64_t pixels() const { return pixels_; }
+
+ private:
+  static uint64_t area(const int16_t* x0, const int16_t* y0, const int16_t* x1,
+                       const int16_t* y1, uint16_t count);
+
+  roo_display::DisplayOutput& delegate_;
+  uint64_t pixels_;
+};
+
+// Records a single paint of a widget, from construction to destruction.
+class PaintStatsScope {
+ public:
+  PaintStatsScope(PaintStatsEntry& entry, const char* name, bool dirty,
+                  bool invalidated, const roo_windows::Canvas& canvas);
+
+  ~PaintStatsScope();
+
+  // The canvas to paint to, so that the pixels get counted.
+  const roo_windows::Canvas& countedCanvas() const { return canvas_; }
+
+ private:
+  PaintStatsEntry& entry_;
+  const char* name_;
+  bool dirty_;
+  bool invalidated_;
+  PixelCounter counter_;
+  roo_windows::Canvas canvas_;
+  roo_time::Uptime start_;
+};
+
+}  // namespace internal
+
+// To be declared as a member of each widget that records its paints.
+#define ROO_DASHBOARD_PAINT_STATS_MEMBER \
+  ::roo_dashboard::internal::PaintStatsEntry paint_stats_entry_{*this}
+
+// To be used at the top of a widget's paintWidgetContents(). Declares
+// `counted_canvas`, which the widget must paint to instead of `canvas`.
+#define ROO_DASHBOARD_PAINT_STATS_SCOPE(name, canvas, counted_canvas)     \
+  ::roo_dashboard::internal::PaintStatsScope paint_stats_scope(           \
+      paint_stats_entry_, name, isDirty(), isInvalidated(), canvas);      \
+  const ::roo_windows::Canvas& counted_canvas =                           \
+      paint_stats_scope.countedCanvas()
+
+#else
+
+#define ROO_DASHBOARD_PAINT_STATS_MEMBER static_assert(true, "")
+
+#define ROO_DASHBOARD_PAINT_STATS_SCOPE(name, canvas, counted_canvas) \
+  const ::roo_windows::Canvas& counted_canvas = canvas
+
+#endif  // ROO_DASHBOARD_PAINT_STATS
+
+}  // namespace roo_dashboard
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace roo_dashboard {
+
+// Column bookkeeping of a chart drawn in 'sweep' mode, as on an
+// oscilloscope: entry n (a sample, or a column's worth of samples) goes to
+// slot (column) n % capacity, so new entries overwrite the oldest ones from
+// left to right, with a short blank gap ahead of the newest entry. That way,
+// adding an entry repaints just a few columns (the new entry, the one that
+// becomes part of the gap, and the oldest one shown), rather than the whole
+// chart.
+class SweepLayout {
+ public:
+  // Width of the blank gap ahead of the newest entry, in columns.
+  static constexpr uint16_t kGapColumns = 4;
+
+  // The capacity is raised to kGapColumns + 1 if smaller.
+  explicit SweepLayout(uint16_t capacity)
+      : capacity_(std::max<uint16_t>(capacity, kGapColumns + 1)) {}
+
+  // Number of slots (columns).
+  uint16_t capacity() const { return capacity_; }
+
+  // Maximum number of entries shown at a time; the rest is the gap.
+  uint16_t shown() const { return capacity_ - kGapColumns; }
+
+  uint16_t slot(uint32_t n) const { return n % capacity_; }
+
+  // Position of the slot relative to the newest of the count entries: 0 for
+  // the newest, capacity - 1 for the oldest.
+  uint32_t age(uint16_t slot, uint32_t count) const {
+    return (count % capacity_ + capacity_ - 1 - slot) % capacity_;
+  }
+
+  // Whether the entry of the specified age exists, and is not in the gap.
+  bool isShown(uint32_t age, uint32_t count) const {
+    return age < count && age < shown();
+  }
+
+  // Calls paint_column(slot) for the slots that need repainting, given the
+  // count of entries, and the first entry that has changed since the last
+  // paint. Repaints all slots if full is true, or if too many entries have
+  // changed; returns true in that case.
+  template <typename PaintColumn>
+  bool repaint(bool full, uint32_t first_changed, uint32_t count,
+               PaintColumn&& paint_column) const {
+    if (full || count - first_changed >= shown()) {
+      for (uint16_t slot = 0; slot < capacity_; ++slot) {
+        paint_column(slot);
+      }
+      return true;
+    }
+    // Only the columns of the changed entries, and the ones that became the
+    // gap.
+    for (uint32_t n = first_changed; n < count; ++n) {
+      paint_column(slot(n));
+      paint_column(slot(n + kGapColumns));
+    }
+    // The oldest shown entry is no longer connected to its predecessor.
+    paint_column(slot(count + kGapColumns));
+    return false;
+  }
+
+ private:
+  uint16_t capacity_;
+};
+
+// Maps the value to the row of a chart of the specified height, with
+// max_value at the top (row 0) and min_value at the bottom, clamping it to
+// that range. If the range is empty, all values map to the middle row.
+inline int16_t ValueToRow(float value, float min_value, float max_value,
+                          int16_t height) {
+  if (max_value == min_value) return (height - 1) / 2;
+  float row = (max_value - value) * (height - 1) / (max_value - min_value);
+  if (!(row > 0)) return 0;
+  if (row > height - 1) return height - 1;
+  return (int16_t)lroundf(row);
+}
+
+}  // namespace roo_dashboard
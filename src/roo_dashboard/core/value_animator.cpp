@@ -0,0 +1,73 @@
+#include "roo_dashboard/core/value_animator.h"
+
+#include <cmath>
+
+namespace roo_dashboard {
+
+ValueAnimator::ValueAnimator()
+    : spec_{.settle_time = roo_time::Micros(0), .max_fps = 0, .precision = 0},
+      value_(0),
+      target_(0),
+      velocity_(0),
+      last_step_(roo_time::Uptime::Now()) {}
+
+void ValueAnimator::setSpec(const AnimationSpec& spec) {
+  spec_ = spec;
+  if (!enabled()) jumpTo(target_);
+}
+
+void ValueAnimator::setTarget(float target) {
+  if (!enabled() || std::isnan(target) || std::isnan(value_)) {
+    jumpTo(target);
+    return;
+  }
+  if (!isAnimating()) {
+    // Starting; don't count the idle time as elapsed.
+    last_step_ = roo_time::Uptime::Now();
+  }
+  target_ = target;
+}
+
+void ValueAnimator::jumpTo(float value) {
+  value_ = value;
+  target_ = value;
+  velocity_ = 0;
+}
+
+bool ValueAnimator::step(roo_time::Uptime now) {
+  if (!isAnimating()) return false;
+  int64_t elapsed = (now - last_step_).inMicros();
+  if (spec_.max_fps > 0 && elapsed < 1000000 / spec_.max_fps) return false;
+  if (elapsed <= 0) return false;
+  last_step_ = now;
+  // Critically damped spring, integrated exactly, with the exponential
+  // approximated by a rational function (as in the well-known 'SmoothDamp').
+  // The spring settles (to within a few %) in about settle_time.
+  float dt = elapsed * 1e-6f;
+  float omega = 5.0f / (spec_.settle_time.inMicros() * 1e-6f);
+  float x = omega * dt;
+  float decay = 1.0f / (1.0f + x + 0.48f * x * x + 0.235f * x * x * x);
+  float offset = value_ - target_;
+  float temp = (velocity_ + omega * offset) * dt;
+  velocity_ = (velocity_ - omega * temp) * decay;
+  float value = target_ + (offset + temp) * decay;
+  // Never overshoot.
+  if ((offset > 0) != (value - target_ > 0) ||
+      fabsf(value - target_) < spec_.precision) {
+    jumpTo(target_);
+    return true;
+  }
+  value_ = value;
+  return true;
+}
+
+bool AnimationClock::tick() {
+  roo_time::Uptime now = roo_time::Uptime::Now();
+  bool animating = false;
+  for (const auto& animation : animations_) {
+    animating |= animation(now);
+  }
+  return animating;
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "roo_time.h"
+
+namespace roo_dashboard {
+
+struct AnimationSpec {
+  // Approximate time for the value to reach a new target. Zero disables the
+  // animation: the value jumps straight to the target.
+  roo_time::Duration settle_time;
+
+  // The maximum number of animation steps per second, bounding the repaint
+  // cost of the animation. Zero means no limit (i.e., a step per frame).
+  uint16_t max_fps;
+
+  // Once the value is closer to the target than this, it snaps to the
+  // target, and the animation ends.
+  float precision;
+};
+
+// Moves a value smoothly toward a target, as a critically damped spring:
+// it approaches the target as fast as possible without overshooting, and
+// retargeting mid-way keeps the velocity, so that the motion stays smooth
+// when new values keep coming.
+//
+// The animation is driven by a frame clock: call step() on each frame. The
+// progress depends on the elapsed time, not on the number of frames, so a
+// slower frame rate (or the max_fps cap) makes the animation coarser, but
+// not slower.
+class ValueAnimator {
+ public:
+  // Initially disabled.
+  ValueAnimator();
+
+  void setSpec(const AnimationSpec& spec);
+
+  bool enabled() const { return spec_.settle_time.inMicros() > 0; }
+
+  float value() const { return value_; }
+  float target() const { return target_; }
+
+  // A NaN value is settled on a NaN target.
+  bool isAnimating() const {
+    return !(value_ == target_) && !(std::isnan(value_) && std::isnan(target_));
+  }
+
+  // Sets the new target. If disabled, or if either the value or the target
+  // is NaN, jumps straight to it; step() then doesn't report the change, so
+  // the caller must apply value() when isAnimating() returns false.
+  void setTarget(float target);
+
+  // Sets the value and the target, stopping the animation.
+  void jumpTo(float value);
+
+  // Advances the animation to the specified time. Returns true if the value
+  // has changed; false if it hasn't, or if the step was skipped because of
+  // the max_fps cap.
+  bool step(roo_time::Uptime now);
+
+ private:
+  AnimationSpec spec_;
+  float value_;
+  float target_;
+
+  // In units per second.
+  float velocity_;
+
+  roo_time::Uptime last_step_;
+};
+
+// Drives the animations of a set of widgets with a frame clock. Call tick()
+// once per frame, before the UI gets refreshed, e.g.:
+//
+//   AnimationClock clock;
+//   gauge.setAnimation(AnimationSpec{.settle_time = roo_time::Millis(300),
+//                                    .max_fps = 30,
+//                                    .precision = 0.05});
+//   clock.add(gauge);
+//   ...
+//   void loop() {
+//     clock.tick();
+//     app.tick();
+//   }
+//
+// The widgets must outlive the clock.
+class AnimationClock {
+ public:
+  // The target must have a method 'bool animate(roo_time::Uptime now)',
+  // which returns true while the animation is in progress.
+  template <typename Animated>
+  void add(Animated& target) {
+    animations_.push_back(
+        [&target](roo_time::Uptime now) { return target.animate(now); });
+  }
+
+  // Advances all animations. Returns true if any is still in progress.
+  bool tick();
+
+ private:
+  std::vector<std::function<bool(roo_time::Uptime)>> animations_;
+};
+
+}  // namespace roo_dashboard
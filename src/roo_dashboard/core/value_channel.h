@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace roo_dashboard {
+
+// Channels for passing values from a single producer (e.g., a sensor task,
+// possibly running on another core) to a single consumer (the UI loop),
+// without locks. The producer never blocks and never waits for the
+// consumer.
+//
+// The consumer typically doesn't poll the channels directly, but binds
+// them to meters via a ChannelDrain, which it drains once per frame.
+
+// Delivers only the most recent value: values published faster than the
+// consumer polls are overwritten. Suitable for meters that show the current
+// value, e.g., a gauge or a thermometer.
+//
+// Implemented as a triple buffer: the producer and the consumer each own a
+// buffer, and swap it with the third one, atomically.
+template <typename T>
+class LatestValueChannel {
+ public:
+  LatestValueChannel() : write_(0), middle_(1), read_(2) {}
+
+  // Called by the producer only.
+  void publish(const T& value) {
+    buffers_[write_] = value;
+    write_ = middle_.exchange(write_ | kFresh, std::memory_order_acq_rel) &
+             kIndexMask;
+  }
+
+  // Called by the consumer only. If a value has been published since the
+  // last call, stores it in 'value' and returns true. Otherwise, returns
+  // false.
+  bool poll(T& value) {
+    if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) return false;
+    read_ = middle_.exchange(read_, std::memory_order_acq_rel) & kIndexMask;
+    value = buffers_[read_];
+    return true;
+  }
+
+ private:
+  static constexpr uint8_t kIndexMask = 0x03;
+
+  // Set in middle_ when it holds a value that the consumer hasn't seen.
+  static constexpr uint8_t kFresh = 0x04;
+
+  T buffers_[3];
+
+  // Owned by the producer.
+  uint8_t write_;
+
+  // Index of the shared buffer, plus the kFresh flag.
+  std::atomic<uint8_t> middle_;
+
+  // Owned by the consumer.
+  uint8_t read_;
+};
+
+// Delivers all values, in order, as long as the consumer keeps up: up to
+// Capacity values can be pending. When the queue is full, new values are
+// dropped (and counted). Suitable for meters that show the history, e.g.,
+// a strip chart. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class QueuedValueChannel {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+ public:
+  QueuedValueChannel() : head_(0), tail_(0), dropped_(0) {}
+
+  // Called by the producer only. Returns false if the queue is full, in
+  // which case the value is dropped.
+  bool push(const T& value) {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+      dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+      return false;
+    }
+    buffer_[tail % Capacity] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Called by the consumer only. If the queue is not empty, removes the
+  // oldest value, stores it in 'value', and returns true. Otherwise,
+  // returns false.
+  bool pop(T& value) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) return false;
+    value = buffer_[head % Capacity];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Number of values dropped because the queue was full.
+  uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  T buffer_[Capacity];
+
+  // Free-running counters of the values popped and pushed, respectively.
+  std::atomic<uint32_t> head_;
+  std::atomic<uint32_t> tail_;
+
+  // Written by the producer only.
+  std::atomic<uint32_t> dropped_;
+};
+
+// Connects channels to the meters (or any other consumers of the values),
+// on the UI thread. Call drain() once per frame, before the UI gets
+// refreshed, e.g.:
+//
+//   LatestValueChannel<float> pressure;  // Published by the sensor task.
+//   ChannelDrain drain;
+//   drain.bind(pressure, [&](float v) { gauge.setValue(v); });
+//   ...
+//   void loop() {
+//     drain.drain();
+//     app.tick();
+//   }
+//
+// The channels must outlive the drain.
+class ChannelDrain {
+ public:
+  // The sink gets called with the latest value, if there is a new one.
+  template <typename T, typename Sink>
+  void bind(LatestValueChannel<T>& channel, Sink sink) {
+    drainers_.push_back([&channel, sink]() {
+      T value;
+      if (channel.poll(value)) sink(value);
+    });
+  }
+
+  // The sink gets called with each pending value, in order. At most
+  // Capacity values are delivered per drain, so that a fast producer cannot
+  // stall the UI loop.
+  template <typename T, size_t Capacity, typename Sink>
+  void bind(QueuedValueChannel<T, Capacity>& channel, Sink sink) {
+    drainers_.push_back([&channel, sink]() {
+      T value;
+      for (size_t i = 0; i < Capacity && channel.pop(value); ++i) {
+        sink(value);
+      }
+    });
+  }
+
+  // Delivers the pending values of all bound channels.
+  void drain() {
+    for (const auto& drainer : drainers_) drainer();
+  }
+
+ private:
+  std::vector<std::function<void()>> drainers_;
+};
+
+}  // namespace roo_dashboard
@@ -0,0 +1,113 @@
+#include "roo_dashboard/meters/decimated_chart.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace roo_display;
+using namespace roo_windows;
+
+namespace roo_dashboard {
+
+DecimatedChart::DecimatedChart(const roo_windows::Environment& env,
+                               uint16_t capacity, uint32_t samples_per_column,
+                               float min_value, float max_value, Mode mode)
+    : roo_windows::Widget(env),
+      layout_(capacity),
+      decimator_(layout_.capacity(), samples_per_column),
+      painted_columns_(0),
+      min_value_(min_value),
+      max_value_(max_value),
+      mode_(mode),
+      color_(env.theme().color.secondary) {}
+
+void DecimatedChart::addSamples(const float* samples, size_t count) {
+  if (count == 0) return;
+  decimator_.add(samples, count);
+  setDirty();
+}
+
+void DecimatedChart::clear() {
+  decimator_.clear();
+  invalidateInterior();
+}
+
+void DecimatedChart::setMode(Mode mode) {
+  if (mode_ == mode) return;
+  mode_ = mode;
+  invalidateInterior();
+}
+
+void DecimatedChart::setRange(float min_value, float max_value) {
+  if (min_value_ == min_value && max_value_ == max_value) return;
+  min_value_ = min_value;
+  max_value_ = max_value;
+  invalidateInterior();
+}
+
+void DecimatedChart::setColor(Color color) {
+  if (color_ == color) return;
+  color_ = color;
+  invalidateInterior();
+}
+
+void DecimatedChart::paintWidgetContents(const Canvas& canvas,
+                                         Clipper& clipper) {
+  ROO_DASHBOARD_PAINT_STATS_SCOPE("DecimatedChart", canvas, counted_canvas);
+  Widget::paintWidgetContents(counted_canvas, clipper);
+  painted_columns_ = decimator_.columnCount();
+}
+
+void DecimatedChart::paint(const Canvas& canvas) const {
+  uint32_t count = decimator_.columnCount();
+  // The column that was in progress during the last paint may have changed.
+  // In the line mode, so may have the LTTB value of the one before it.
+  uint32_t lookback = (mode_ == kLine ? 2 : 1);
+  uint32_t first = painted_columns_ > lookback ? painted_columns_ - lookback
+                                               : 0;
+  auto paint_column = [&](uint16_t slot) { paintColumn(canvas, slot); };
+  bool full = layout_.repaint(isInvalidated(), first, count, paint_column);
+  if (full && layout_.capacity() < width()) {
+    canvas.clearRect(layout_.capacity(), 0, width() - 1, height() - 1);
+  }
+}
+
+void DecimatedChart::paintColumn(const Canvas& canvas, uint16_t slot) const {
+  XDim x = slot;
+  if (x >= width()) return;
+  uint32_t count = decimator_.columnCount();
+  uint32_t age = layout_.age(slot, count);
+  if (!layout_.isShown(age, count) ||
+      decimator_.column(count - 1 - age).empty()) {
+    canvas.clearRect(x, 0, x, height() - 1);
+    return;
+  }
+  uint32_t n = count - 1 - age;
+  const ColumnEnvelope& column = decimator_.column(n);
+  // The previous column, if shown, and not empty.
+  const ColumnEnvelope* previous = nullptr;
+  if (layout_.isShown(age + 1, count) && !decimator_.column(n - 1).empty()) {
+    previous = &decimator_.column(n - 1);
+  }
+  float low, high;
+  if (mode_ == kEnvelope) {
+    low = column.min;
+    high = column.max;
+    if (previous != nullptr) {
+      low = std::min(low, previous->last);
+      high = std::max(high, previous->last);
+    }
+  } else {
+    low = high = column.selected;
+    if (previous != nullptr) {
+      low = std::min(low, previous->selected);
+      high = std::max(high, previous->selected);
+    }
+  }
+  int16_t y_min = toRow(high);
+  int16_t y_max = toRow(low);
+  if (y_min > 0) canvas.clearRect(x, 0, x, y_min - 1);
+  canvas.fillRect(x, y_min, x, y_max, AlphaBlend(canvas.bgcolor(), color_));
+  if (y_max < height() - 1) canvas.clearRect(x, y_max + 1, x, height() - 1);
+}
+
+}  // namespace roo_dashboard
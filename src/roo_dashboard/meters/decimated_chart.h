@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "roo_dashboard/core/decimator.h"
+#include "roo_dashboard/core/paint_stats.h"
+#include "roo_dashboard/core/sweep_layout.h"
+#include "roo_display/color/color.h"
+#include "roo_windows/core/canvas.h"
+#include "roo_windows/core/widget.h"
+
+namespace roo_dashboard {
+
+// Recent history of a high-rate series (e.g., sampled at kHz rates), with
+// many samples per pixel column.
+//
+// The samples go through a Decimator, which reduces each column's worth of
+// samples to its envelope, so the memory use is O(columns), regardless of
+// the sample rate. In the envelope mode, each column shows the range
+// between the min and the max of its samples (extended to the last sample
+// of the previous column, so that the trace is continuous). In the line
+// mode, each column shows the value picked by the LTTB method, connected to
+// the previous one.
+//
+// Like StripChart, the chart is drawn in 'sweep' mode (see SweepLayout), so
+// that adding samples repaints just the affected columns.
+class DecimatedChart : public roo_windows::Widget {
+ public:
+  enum Mode { kEnvelope, kLine };
+
+  // Width of the blank gap ahead of the newest column, in columns.
+  static constexpr uint16_t kGapColumns = SweepLayout::kGapColumns;
+
+  // The capacity is the number of columns of the chart; it must be larger
+  // than kGapColumns. The values are plotted between min_value (at the
+  // bottom) and max_value (at the top), and clamped to that range.
+  DecimatedChart(const roo_windows::Environment& env, uint16_t capacity,
+                 uint32_t samples_per_column, float min_value,
+                 float max_value, Mode mode = kEnvelope);
+
+  // Adds the samples, in order. NaN samples are skipped.
+  void addSamples(const float* samples, size_t count);
+
+  void addSample(float sample) { addSamples(&sample, 1); }
+
+  // Removes all samples.
+  void clear();
+
+  void setMode(Mode mode);
+
+  void setRange(float min_value, float max_value);
+
+  void setColor(roo_display::Color color);
+
+  Mode mode() const { return mode_; }
+
+  const Decimator& decimator() const { return decimator_; }
+
+  roo_windows::Dimensions getSuggestedMinimumDimensions() const override {
+    return roo_windows::Dimensions(layout_.capacity(), 20);
+  }
+
+  void paintWidgetContents(const roo_windows::Canvas& canvas,
+                           roo_windows::Clipper& clipper) override;
+
+  void paint(const roo_windows::Canvas& canvas) const override;
+
+ private:
+  // Maps the value to the row.
+  int16_t toRow(float value) const {
+    return ValueToRow(value, min_value_, max_value_, height());
+  }
+
+  // Paints the column of the specified slot of the ring buffer.
+  void paintColumn(const roo_windows::Canvas& canvas, uint16_t slot) const;
+
+  SweepLayout layout_;
+
+  // Column n is stored in slot layout_.slot(n).
+  Decimator decimator_;
+
+  // Column count as of the last paint.
+  uint32_t painted_columns_;
+
+  float min_value_;
+  float max_value_;
+  Mode mode_;
+  roo_display::Color color_;
+
+  ROO_DASHBOARD_PAINT_STATS_MEMBER;
+};
+
+}  // namespace roo_dashboard
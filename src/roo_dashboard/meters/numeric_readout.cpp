@@ -0,0 +1,177 @@
+#include "roo_dashboard/meters/numeric_readout.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "roo_display.h"
+#include "roo_display/core/offscreen.h"
+#include "roo_display/core/raster.h"
+#include "roo_display/ui/text_label.h"
+
+using namespace roo_display;
+using namespace roo_windows;
+
+namespace roo_dashboard {
+
+namespace {
+
+// Characters that can appear in the cells, other than the space.
+constexpr char kGlyphs[] = "0123456789+-.";
+constexpr uint8_t kGlyphCount = sizeof(kGlyphs) - 1;
+
+int glyphIndex(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c == '+') return 10;
+  if (c == '-') return 11;
+  if (c == '.') return 12;
+  return -1;
+}
+
+// Returns true if the cells can show the number, i.e. it fits, and it is not
+// "ovf" or "nan".
+bool fitsCells(const FormattedNumber& formatted, uint8_t cell_count) {
+  if (formatted.size() > cell_count) return false;
+  for (const char* c = formatted.c_str(); *c != '\0'; ++c) {
+    if (*c != ' ' && glyphIndex(*c) < 0) return false;
+  }
+  return true;
+}
+
+// Size of a 4bpp mask of the given dimensions, in bytes.
+size_t maskSize(int16_t width, int16_t height) {
+  return ((size_t)width * height + 1) / 2;
+}
+
+int16_t textAdvance(const Font& font, const char* text) {
+  if (*text == '\0') return 0;
+  return font.getHorizontalStringMetrics(text).advance();
+}
+
+}  // namespace
+
+NumericReadout::NumericReadout(const Environment& env, const Font& font,
+                               const NumberFormat& format, uint8_t cell_count,
+                               float initial_value)
+    : Widget(env),
+      font_(font),
+      number_format_(format),
+      cell_count_(std::min(cell_count, kMaxCells)),
+      cell_width_(0),
+      cell_height_(font.metrics().maxHeight()),
+      baseline_(font.metrics().ascent()),
+      color_(env.theme().color.onBackground),
+      value_(std::nanf("")) {
+  memcpy(prefix_, format.prefix, sizeof(prefix_));
+  memcpy(suffix_, format.suffix, sizeof(suffix_));
+  number_format_.prefix[0] = '\0';
+  number_format_.suffix[0] = '\0';
+  prefix_width_ = textAdvance(font, prefix_);
+  suffix_width_ = textAdvance(font, suffix_);
+  for (uint8_t i = 0; i < kGlyphCount; ++i) {
+    char glyph[] = {kGlyphs[i], '\0'};
+    cell_width_ = std::max(cell_width_, textAdvance(font, glyph));
+  }
+  memset(cells_, '-', sizeof(cells_));
+  memset(painted_cells_, '\0', sizeof(painted_cells_));
+  renderGlyphs();
+  setValue(initial_value);
+}
+
+void NumericReadout::renderGlyphs() {
+  size_t mask_size = maskSize(cell_width_, cell_height_);
+  glyphs_.reset(new uint8_t[mask_size * kGlyphCount]);
+  memset(glyphs_.get(), 0, mask_size * kGlyphCount);
+  for (uint8_t i = 0; i < kGlyphCount; ++i) {
+    Offscreen<Alpha4> offscreen(Box(0, 0, cell_width_ - 1, cell_height_ - 1),
+                                glyphs_.get() + i * mask_size,
+                                Alpha4(color::Black));
+    DrawingContext dc(offscreen);
+    char glyph[] = {kGlyphs[i], '\0'};
+    // Centered in the cell.
+    int16_t x = (cell_width_ - textAdvance(font_, glyph)) / 2;
+    dc.draw(TextLabel(glyph, font_, color::Black), x, baseline_);
+  }
+}
+
+void NumericReadout::setValue(float value) {
+  if (value_ == value || (std::isnan(value_) && std::isnan(value))) return;
+  value_ = value;
+  char cells[kMaxCells];
+  FormattedNumber formatted(value, number_format_);
+  if (!fitsCells(formatted, cell_count_)) {
+    memset(cells, '-', cell_count_);
+  } else {
+    uint8_t padding = cell_count_ - formatted.size();
+    memset(cells, ' ', padding);
+    memcpy(cells + padding, formatted.c_str(), formatted.size());
+  }
+  if (memcmp(cells, cells_, cell_count_) == 0) return;
+  memcpy(cells_, cells, cell_count_);
+  setDirty();
+}
+
+void NumericReadout::setColor(Color color) {
+  if (color_ == color) return;
+  color_ = color;
+  invalidateInterior();
+}
+
+Dimensions NumericReadout::getSuggestedMinimumDimensions() const {
+  return Dimensions(prefix_width_ + cell_count_ * cell_width_ + suffix_width_,
+                    cell_height_);
+}
+
+void NumericReadout::paintWidgetContents(const Canvas& canvas,
+                                         Clipper& clipper) {
+  ROO_DASHBOARD_PAINT_STATS_SCOPE("NumericReadout", canvas, counted_canvas);
+  Widget::paintWidgetContents(counted_canvas, clipper);
+  memcpy(painted_cells_, cells_, cell_count_);
+}
+
+void NumericReadout::paint(const Canvas& canvas) const {
+  bool full = isInvalidated();
+  if (full) {
+    // The static parts: the prefix, the suffix, and whatever area remains
+    // around the cells.
+    XDim cells_x = prefix_width_;
+    XDim suffix_x = cells_x + cell_count_ * cell_width_;
+    if (cells_x > 0) canvas.clearRect(Rect(0, 0, cells_x - 1, height() - 1));
+    if (suffix_x < width()) {
+      canvas.clearRect(Rect(suffix_x, 0, width() - 1, height() - 1));
+    }
+    if (cell_height_ < height()) {
+      canvas.clearRect(
+          Rect(cells_x, cell_height_, suffix_x - 1, height() - 1));
+    }
+    DrawingContext dc(canvas);
+    if (prefix_width_ > 0) {
+      dc.draw(TextLabel(prefix_, font_, color_), 0, baseline_);
+    }
+    if (suffix_width_ > 0) {
+      dc.draw(TextLabel(suffix_, font_, color_), suffix_x, baseline_);
+    }
+  }
+  for (uint8_t i = 0; i < cell_count_; ++i) {
+    if (full || cells_[i] != painted_cells_[i]) paintCell(canvas, i);
+  }
+}
+
+void NumericReadout::paintCell(const Canvas& canvas, uint8_t cell) const {
+  XDim x = prefix_width_ + cell * cell_width_;
+  int index = glyphIndex(cells_[cell]);
+  if (index < 0) {
+    canvas.clearRect(Rect(x, 0, x + cell_width_ - 1, cell_height_ - 1));
+    return;
+  }
+  // The whole cell, including the background, so that the previous glyph
+  // gets erased in the same pass.
+  DrawingContext dc(canvas);
+  dc.setFillMode(FillMode::kExtents);
+  dc.draw(ConstDramRaster<Alpha4>(
+      Box(x, 0, x + cell_width_ - 1, cell_height_ - 1),
+      glyphs_.get() + index * maskSize(cell_width_, cell_height_),
+      Alpha4(color_)));
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+#include "roo_dashboard/core/number_format.h"
+#include "roo_dashboard/core/paint_stats.h"
+#include "roo_display/font/font.h"
+#include "roo_windows/core/widget.h"
+
+namespace roo_dashboard {
+
+// A number, e.g. "23.4°C", shown in fixed-advance character cells, for
+// values that change often.
+//
+// The glyphs that can appear in the cells (digits, sign, decimal point) are
+// rendered once, when the readout is created. When the value changes, only
+// the cells whose character changed get repainted, so that going from 23.4
+// to 23.5 redraws a single cell. The prefix and the suffix of the format
+// (e.g., the unit) are static, and painted only when the readout is
+// invalidated.
+//
+// NaN, and numbers that do not fit in the cells, are shown as dashes.
+class NumericReadout : public roo_windows::Widget {
+ public:
+  // Maximum number of cells.
+  static constexpr uint8_t kMaxCells = 16;
+
+  // The cell_count is the maximum number of characters of the number,
+  // including the sign and the decimal point. The number is right-aligned.
+  NumericReadout(const roo_windows::Environment& env,
+                 const roo_display::Font& font, const NumberFormat& format,
+                 uint8_t cell_count, float initial_value = std::nanf(""));
+
+  void setValue(float value);
+
+  float value() const { return value_; }
+
+  void setColor(roo_display::Color color);
+
+  roo_windows::Dimensions getSuggestedMinimumDimensions() const override;
+
+  void paintWidgetContents(const roo_windows::Canvas& canvas,
+                           roo_windows::Clipper& clipper) override;
+
+  void paint(const roo_windows::Canvas& canvas) const override;
+
+ private:
+  // Renders the cell glyphs of the font into glyphs_.
+  void renderGlyphs();
+
+  // Paints the cell, in widget coordinates.
+  void paintCell(const roo_windows::Canvas& canvas, uint8_t cell) const;
+
+  const roo_display::Font& font_;
+
+  // The format of the cells, i.e. without the prefix and the suffix.
+  NumberFormat number_format_;
+  char prefix_[sizeof(NumberFormat::prefix)];
+  char suffix_[sizeof(NumberFormat::suffix)];
+
+  uint8_t cell_count_;
+  int16_t cell_width_;
+  int16_t cell_height_;
+  int16_t baseline_;
+  int16_t prefix_width_;
+  int16_t suffix_width_;
+
+  roo_display::Color color_;
+
+  // 4-bit alpha masks of the glyphs, cell_width_ x cell_height_ each, in the
+  // order of kGlyphs (see the .cpp).
+  std::unique_ptr<uint8_t[]> glyphs_;
+
+  float value_;
+
+  // Characters of the cells, right now, and as of the last paint.
+  char cells_[kMaxCells];
+  char painted_cells_[kMaxCells];
+
+  ROO_DASHBOARD_PAINT_STATS_MEMBER;
+};
+
+}  // namespace roo_dashboard
@@ -2,8 +2,9 @@
 
 #include <cmath>
 
+#include "roo_dashboard/core/linear_meter.h"
+#include "roo_dashboard/core/number_format.h"
 #include "roo_display/color/color.h"
-#include "roo_display/core/rasterizable.h"
 #include "roo_display/filter/background.h"
 #include "roo_windows/core/theme.h"
 #include "roo_smooth_fonts/NotoSans_Regular/12.h"
@@ -16,47 +17,12 @@ namespace roo_dashboard {
 
 namespace {
 
-class BarRaster : public roo_display::Rasterizable {
- public:
-  BarRaster(roo_display::Box extents, Color complete, Color incomplete,
-            int16_t threshold)
-      : extents_(std::move(extents)),
-        complete_(complete),
-        incomplete_(incomplete),
-        threshold_(threshold) {}
-
-  void readColors(const int16_t* x, const int16_t* y, uint32_t count,
-                  Color* result) const override {
-    while (count-- > 0) {
-      *result++ = *x++ < threshold_ ? complete_ : incomplete_;
-    }
-  }
-
-  bool readColorRect(int16_t xMin, int16_t yMin, int16_t xMax, int16_t yMax,
-                     Color* result) const override {
-    if (xMin >= extents_.xMin() && xMax <= extents_.xMax() &&
-        yMin >= extents_.yMin() && yMax <= extents_.yMax()) {
-      if (xMax < threshold_) {
-        *result = complete_;
-        return true;
-      }
-      if (xMin >= threshold_) {
-        *result = incomplete_;
-        return true;
-      }
-    }
-    // Fall back to the slow path.
-    return Rasterizable::readColorRect(xMin, yMin, xMax, yMax, result);
-  }
-
-  roo_display::Box extents() const override { return extents_; }
+// The last pixel of the 'complete' part of the bar, or -1 if none.
+int16_t progressEnd(uint16_t progress, int16_t width) {
+  return (int16_t)((uint32_t)progress * width / 1024) - 1;
+}
 
- private:
-  roo_display::Box extents_;
-  Color complete_;
-  Color incomplete_;
-  int16_t threshold_;
-};
+const NumberFormat kPercentFormat{.precision = 0, .suffix = "%"};
 
 Color defaultIncompleteColor(const Theme& theme, Color complete) {
   complete.set_a(theme.state.disabled);
@@ -69,11 +35,48 @@ BaseProgressBar::BaseProgressBar(const roo_windows::Environment& env)
     : roo_windows::VerticalLayout(env),
       progress_(0),
       complete_(env.theme().color.secondary),
-      incomplete_(defaultIncompleteColor(env.theme(), complete_)) {}
+      incomplete_(defaultIncompleteColor(env.theme(), complete_)),
+      color_lut_(nullptr) {}
 
 void BaseProgressBar::setColor(roo_display::Color color) {
   complete_ = color;
   incomplete_ = defaultIncompleteColor(theme(), color);
+  color_lut_ = nullptr;
+}
+
+void BaseProgressBar::setProgress(uint16_t progress) {
+  if (progress < 0) progress = 0;
+  if (progress > 1024) progress = 1024;
+  if (progress == progress_) return;
+  int16_t old_end = progressEnd(progress_, width());
+  int16_t new_end = progressEnd(progress, width());
+  progress_ = progress;
+  updateChildren();
+  if (color_lut_ != nullptr && updateLutColors()) {
+    invalidateInterior();
+    return;
+  }
+  // Only the span between the old and the new end changes. The label, if
+  // changed, has already invalidated itself.
+  // (With no zero line, the change is a single span.)
+  LinearSpan span = LinearMeter<HorizontalOrientation>::ChangedSpans(
+                        -1, old_end, new_end, false)
+                        .first;
+  if (span.empty()) return;
+  invalidateInterior(HorizontalOrientation::ToRect(span, width(), height()));
+}
+
+void BaseProgressBar::setColoring(const GradientLut& lut) {
+  color_lut_ = &lut;
+  if (updateLutColors()) invalidateInterior();
+}
+
+bool BaseProgressBar::updateLutColors() {
+  Color complete = color_lut_->getColor(progress_ * 100.0f / 1024);
+  if (complete == complete_) return false;
+  complete_ = complete;
+  incomplete_ = defaultIncompleteColor(theme(), complete);
+  return true;
 }
 
 PreferredSize BaseProgressBar::getPreferredSize() const {
@@ -85,10 +88,12 @@ void BaseProgressBar::setColors(roo_display::Color complete,
                                 roo_display::Color incomplete) {
   complete_ = complete;
   incomplete_ = incomplete;
+  color_lut_ = nullptr;
 }
 
-void BaseProgressBar::paintWidgetContents(const Canvas& canvas,
+void BaseProgressBar::paintWidgetContents(const Canvas& widget_canvas,
                                           Clipper& clipper) {
+  ROO_DASHBOARD_PAINT_STATS_SCOPE("ProgressBar", widget_canvas, canvas);
   if (!isDirty()) {
     Panel::paintWidgetContents(canvas, clipper);
     return;
@@ -105,11 +110,11 @@ void BaseProgressBar::paintWidgetContents(const Canvas& canvas,
     return;
   }
 
-  BarRaster bar(Box(canvas.dx(), canvas.dy(), width() + canvas.dx() - 1,
-                    height() + canvas.dy() - 1),
-                AlphaBlend(canvas.bgcolor(), complete_),
-                AlphaBlend(canvas.bgcolor(), incomplete_),
-                (uint32_t)progress_ * width() / 1024 + canvas.dx());
+  LinearMeterRaster<HorizontalOrientation> bar(
+      Box(canvas.dx(), canvas.dy(), width() + canvas.dx() - 1,
+          height() + canvas.dy() - 1),
+      progressEnd(progress_, width()), AlphaBlend(canvas.bgcolor(), complete_),
+      AlphaBlend(canvas.bgcolor(), incomplete_));
   BackgroundFilter filter(my_canvas.out(), &bar);
   my_canvas.set_out(&filter);
   my_canvas.set_bgcolor(color::Background);
@@ -119,7 +124,8 @@ void BaseProgressBar::paintWidgetContents(const Canvas& canvas,
 PercentProgressBar::PercentProgressBar(const roo_windows::Environment& env)
     : BaseProgressBar(env),
       percent_(env, "0%", font_button(),
-               roo_windows::kGravityCenter | roo_windows::kGravityMiddle) {
+               roo_windows::kGravityCenter | roo_windows::kGravityMiddle),
+      percent_shown_(0) {
   setGravity(roo_windows::kGravityCenter | roo_windows::kGravityMiddle);
   percent_.setPadding(roo_windows::PaddingSize::kNone);
   percent_.setMargins(roo_windows::MarginSize::kNone);
@@ -128,7 +134,12 @@ PercentProgressBar::PercentProgressBar(const roo_windows::Environment& env)
 }
 
 void PercentProgressBar::updateChildren() {
-  percent_.setTextf("%d%%", progress_ * 100 / 1024);
+  // Many progress values map to the same percentage; only touch the label
+  // (which reformats and re-measures the text) when it actually changes.
+  int percent = progress_ * 100 / 1024;
+  if (percent == percent_shown_) return;
+  percent_shown_ = percent;
+  percent_.setText(FormattedNumber(percent, kPercentFormat).c_str());
 }
 
 }  // namespace roo_dashboard
@@ -3,6 +3,8 @@
 #include <functional>
 #include <string>
 
+#include "roo_dashboard/core/gradient_lut.h"
+#include "roo_dashboard/core/paint_stats.h"
 #include "roo_windows/containers/vertical_layout.h"
 #include "roo_windows/core/canvas.h"
 #include "roo_windows/core/panel.h"
@@ -16,21 +18,7 @@ class BaseProgressBar : public roo_windows::VerticalLayout {
  public:
   BaseProgressBar(const roo_windows::Environment& env);
 
-  void setProgress(uint16_t progress) {
-    if (progress < 0) progress = 0;
-    if (progress > 1024) progress = 1024;
-    if (progress == progress_) return;
-    uint16_t pixel_threshold_old = (uint32_t)progress_ * width() / 1024;
-    uint16_t pixel_threshold_new = (uint32_t)progress * width() / 1024;
-    progress_ = progress;
-    updateChildren();
-    if (pixel_threshold_old != pixel_threshold_new) {
-      invalidateInterior(roo_windows::Rect(
-          std::min(pixel_threshold_old, pixel_threshold_new), 0,
-          std::max(pixel_threshold_old, pixel_threshold_new) - 1,
-          height() - 1));
-    }
-  }
+  void setProgress(uint16_t progress);
 
   roo_windows::PreferredSize getPreferredSize() const override;
 
@@ -40,14 +28,29 @@ class BaseProgressBar : public roo_windows::VerticalLayout {
 
   void setColors(roo_display::Color complete, roo_display::Color incomplete);
 
+  // Makes the 'complete' color follow the progress, taking it from the lookup
+  // table indexed by percentage (0-100). The 'incomplete' color is the same
+  // color with translucency. The table must outlive the progress bar.
+  void setColoring(const GradientLut& lut);
+
   void paintWidgetContents(const roo_windows::Canvas& canvas,
                            roo_windows::Clipper& clipper) override;
 
  protected:
+  // Updates the children to reflect progress_. The children invalidate
+  // themselves as needed.
   virtual void updateChildren() {}
+
+  // Sets the colors from color_lut_, according to progress_. Returns true if
+  // they changed.
+  bool updateLutColors();
+
   uint16_t progress_;  // 0-1024 (corresponding to 0-100%).
   roo_display::Color complete_;
   roo_display::Color incomplete_;
+  const GradientLut* color_lut_;
+
+  ROO_DASHBOARD_PAINT_STATS_MEMBER;
 };
 
 // A progress bar that goes from 0% to 100%, showing percentage in the middle of
@@ -64,6 +67,9 @@ class PercentProgressBar : public BaseProgressBar {
 
  private:
   roo_windows::TextLabel percent_;
+
+  // The percentage currently shown by the label.
+  int percent_shown_;
 };
 
 }  // namespace roo_dashboard
@@ -1,7 +1,14 @@
 #include "roo_dashboard/meters/radial_gauge.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
 
+#include "roo_dashboard/core/compressed_raster.h"
+#include "roo_dashboard/core/number_format.h"
+#include "roo_dashboard/core/polar.h"
 #include "roo_display.h"
 #include "roo_display/color/gradient.h"
 #include "roo_display/core/offscreen.h"
@@ -10,7 +17,6 @@
 #include "roo_display/shape/basic.h"
 #include "roo_display/shape/smooth.h"
 #include "roo_display/ui/text_label.h"
-#include "roo_io/text/string_printf.h"
 #include "roo_smooth_fonts/NotoSans_Condensed/15.h"
 #include "roo_windows/core/widget.h"
 
@@ -23,24 +29,273 @@ static constexpr float kPi = 3.141592653589793238462643383279502884;
 
 namespace {
 
-struct Point {
-  int16_t x;
-  int16_t y;
+// Same as printf's "%2.f".
+const NumberFormat kScaleLabelFormat{.precision = 0, .width = 2};
+
+const FpPoint polarToCartFp(BinaryAngle angle, float radius, FpPoint center) {
+  float scale = radius / kQ16One;
+  return FpPoint{.x = center.x + SinQ16(angle) * scale,
+                 .y = center.y - CosQ16(angle) * scale};
+}
+
+// Returns the angle corresponding to the specified value on the scale, without
+// clamping to the needle range.
+float scaleDeg(const RadialGauge::Spec& spec, float val) {
+  return spec.deg_scale_start +
+         (val - spec.min_scale_value) /
+             (spec.max_scale_value - spec.min_scale_value) *
+             (spec.deg_scale_end - spec.deg_scale_start);
+}
+
+// A ray from the center of the gauge, at the specified binary angle. The
+// direction is in Q16, in the screen coordinates (y growing downwards).
+struct Ray {
+  Ray() : x(0), y(0) {}
+  Ray(BinaryAngle angle) : x(SinQ16(angle)), y(-CosQ16(angle)) {}
+
+  // Returns the signed distance (in Q16 px) of the point from the line of the
+  // ray; positive on the clockwise side.
+  int32_t cross(int32_t dx, int32_t dy) const { return x * dy - y * dx; }
+
+  // Positive if the point is in front of the center, rather than behind it.
+  int32_t dot(int32_t dx, int32_t dy) const { return x * dx + y * dy; }
+
+  int32_t x, y;
 };
 
-const Point polarToCart(float deg, float radius, Point center) {
-  return Point{
-      .x = (int16_t)(center.x +
-                     std::roundf(sin(deg * 2 * kPi / 360.0) * radius)),
-      .y = (int16_t)(center.y +
-                     std::roundf(-cos(deg * 2 * kPi / 360.0) * radius))};
+// Returns the coverage (in 1/256 units) of a pixel whose center lies at the
+// squared distance r2 from the center of a disc with the specified radius.
+// Within the 1-px anti-aliased fringe, (distance - radius) is approximated by
+// (r2 - radius^2) / (2 * radius), which avoids the square root.
+int32_t DiscCoverage(int32_t r2, int32_t radius) {
+  int32_t d = r2 - radius * radius;
+  if (d <= -radius) return 256;
+  if (d >= radius) return 0;
+  return 128 - d * 128 / radius;
 }
 
-const FpPoint polarToCartFp(float deg, float radius, FpPoint center) {
-  return FpPoint{.x = center.x + sinf(deg * 2 * kPi / 360.0) * radius,
-                 .y = center.y - cosf(deg * 2 * kPi / 360.0) * radius};
+// Converts a signed distance from an edge, in Q16 px, to the coverage (in
+// 1/256 units) of the pixel on the positive side of the edge.
+int32_t EdgeCoverage(int32_t distance) {
+  int32_t c = 128 + (distance >> 8);
+  return c < 0 ? 0 : (c > 256 ? 256 : c);
 }
 
+// The colored band of the scale, along with the thin black rim at its inner
+// edge. It is an annular sector, evaluated analytically per pixel, with
+// anti-aliased edges. As in the original triangle-based rendering, the band is
+// divided into segments ~3 px long, each having a uniform color.
+//
+// The paint path uses integer arithmetic only: radii are compared squared,
+// and the sector edges and the segment boundaries are tested by cross products
+// against precomputed rays. Requires the band to fit within 8192 px of the
+// center, so that the products don't overflow.
+class ScaleBand : public Rasterizable {
+ public:
+  ScaleBand(const RadialGauge::Spec& spec)
+      : cx_(spec.x_center),
+        cy_(spec.y_center),
+        r_rim_(spec.radius - 1),
+        r_in_sq_((int32_t)spec.radius * spec.radius),
+        r_out_(spec.radius + spec.scale_width),
+        full_circle_(false),
+        wide_(false),
+        segment_span_(0),
+        extents_(0, 0, -1, -1) {
+    float scale = spec.deg_scale_end - spec.deg_scale_start;
+    // An empty (or inverted, or NaN) scale has nothing to draw.
+    if (!(scale > 0)) return;
+    if (scale > 360) scale = 360;
+    float len = scale * (2 * kPi * spec.radius + spec.scale_width) / 360.0;
+    int segments = std::max((int)(len / 3), 1);
+    colors_.reserve(segments);
+    for (int i = 0; i < segments; ++i) {
+      float val =
+          spec.min_scale_value +
+          (i * (spec.max_scale_value - spec.min_scale_value) / segments);
+      colors_.push_back(spec.scale_lut != nullptr
+                            ? spec.scale_lut->getColor(val)
+                            : spec.scale_color(val));
+    }
+
+    // The angular geometry, in binary angles relative to the start.
+    BinaryAngle start = DegToBinaryAngle(spec.deg_scale_start);
+    int32_t span = (int32_t)lroundf(scale * (65536.0f / 360.0f));
+    full_circle_ = (span >= 65536);
+    wide_ = (span >= 32768);
+    segment_span_ = span / segments;
+    start_ = Ray(start);
+    end_ = Ray((BinaryAngle)(start + span));
+    boundaries_.reserve(segments - 1);
+    for (int i = 1; i < segments; ++i) {
+      int32_t rel = (int32_t)((int64_t)span * i / segments);
+      boundaries_.push_back(
+          Boundary{.ray = Ray((BinaryAngle)(start + rel)),
+                   .second_half = (rel >= 32768)});
+    }
+
+    // The bounding box of the sector is determined by its corners, and by the
+    // outer arc crossing the axes.
+    float deg_start = spec.deg_scale_start;
+    float deg_end = deg_start + scale;
+    PolarPoint center{.x = spec.x_center, .y = spec.y_center};
+    int16_t r_out = r_out_ + 1;
+    int16_t r_rim = r_rim_ - 1;
+    PolarPoint p[] = {
+        PolarToCart(DegToBinaryAngle(deg_start), r_out, center),
+        PolarToCart(DegToBinaryAngle(deg_start), r_rim, center),
+        PolarToCart(DegToBinaryAngle(deg_end), r_out, center),
+        PolarToCart(DegToBinaryAngle(deg_end), r_rim, center)};
+    int16_t x_min = p[0].x, x_max = p[0].x, y_min = p[0].y, y_max = p[0].y;
+    for (const PolarPoint& q : p) {
+      x_min = std::min(x_min, q.x);
+      x_max = std::max(x_max, q.x);
+      y_min = std::min(y_min, q.y);
+      y_max = std::max(y_max, q.y);
+    }
+    for (int deg = -720; deg <= 720; deg += 90) {
+      if (deg <= deg_start || deg >= deg_end) continue;
+      PolarPoint q = PolarToCart(DegToBinaryAngle(deg), r_out, center);
+      x_min = std::min(x_min, q.x);
+      x_max = std::max(x_max, q.x);
+      y_min = std::min(y_min, q.y);
+      y_max = std::max(y_max, q.y);
+    }
+    extents_ = Box::Intersect(Box(x_min - 1, y_min - 1, x_max + 1, y_max + 1),
+                              spec.extents);
+  }
+
+  Box extents() const override { return extents_; }
+
+  void readColors(const int16_t* x, const int16_t* y, uint32_t count,
+                  Color* result) const override {
+    while (count-- > 0) {
+      *result++ = colorAt(*x++ - cx_, *y++ - cy_);
+    }
+  }
+
+  bool readColorRect(int16_t xMin, int16_t yMin, int16_t xMax, int16_t yMax,
+                     Color* result) const override {
+    int32_t dx0 = xMin - cx_, dx1 = xMax - cx_;
+    int32_t dy0 = yMin - cy_, dy1 = yMax - cy_;
+    // Squared distance range between the center and the rectangle.
+    int32_t nx = (dx0 > 0) ? dx0 : (dx1 < 0 ? dx1 : 0);
+    int32_t ny = (dy0 > 0) ? dy0 : (dy1 < 0 ? dy1 : 0);
+    int32_t fx = std::max(std::abs(dx0), std::abs(dx1));
+    int32_t fy = std::max(std::abs(dy0), std::abs(dy1));
+    int32_t d_min_sq = nx * nx + ny * ny;
+    int32_t d_max_sq = fx * fx + fy * fy;
+    if (DiscCoverage(d_max_sq, r_rim_) == 256 ||
+        DiscCoverage(d_min_sq, r_out_) == 0) {
+      *result = color::Transparent;
+      return true;
+    }
+    if (d_min_sq >= r_in_sq_ && DiscCoverage(d_max_sq, r_out_) == 256 &&
+        segment_span_ < 32768) {
+      // Within the band radially. Check if all corners fall into the same
+      // segment, away from the sector edges. Since the segment is narrower
+      // than a half-turn, it is convex, so then the entire rectangle is
+      // within it.
+      int s = segmentAt(dx0, dy0);
+      if (withinSegment(s, dx0, dy0) && withinSegment(s, dx0, dy1) &&
+          withinSegment(s, dx1, dy0) && withinSegment(s, dx1, dy1)) {
+        *result = colors_[s];
+        return true;
+      }
+    }
+    // Fall back to the slow path.
+    return Rasterizable::readColorRect(xMin, yMin, xMax, yMax, result);
+  }
+
+ private:
+  struct Boundary {
+    Ray ray;
+    // Whether the boundary is at least a half-turn away from the start.
+    bool second_half;
+  };
+
+  // Returns whether the point is at least a half-turn (clockwise) away from
+  // the start.
+  bool inSecondHalf(int32_t dx, int32_t dy) const {
+    int32_t c = start_.cross(dx, dy);
+    return c < 0 || (c == 0 && start_.dot(dx, dy) < 0);
+  }
+
+  // Returns the index of the segment that contains the point, assuming that
+  // the point is within the sector. Within the same half-turn, the cross
+  // product with a boundary ray tells which side of it the point is on.
+  int segmentAt(int32_t dx, int32_t dy) const {
+    bool second_half = inSecondHalf(dx, dy);
+    int lo = 0;
+    int hi = boundaries_.size();
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      const Boundary& b = boundaries_[mid];
+      bool past = (b.second_half != second_half)
+                      ? second_half
+                      : b.ray.cross(dx, dy) >= 0;
+      if (past) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  // Returns whether the point lies within the segment, and, if the segment is
+  // at the edge of the sector, is fully covered (away from the anti-aliased
+  // edge).
+  bool withinSegment(int s, int32_t dx, int32_t dy) const {
+    int last = colors_.size() - 1;
+    // Pixels exactly on a boundary belong to the following segment. At the
+    // sector edges, the margin keeps off the anti-aliased half-pixel.
+    int32_t lo = (s == 0) ? start_.cross(dx, dy) - (full_circle_ ? 0 : 32768)
+                          : boundaries_[s - 1].ray.cross(dx, dy);
+    int32_t hi = (s == last) ? -end_.cross(dx, dy) - (full_circle_ ? 1 : 32768)
+                             : -boundaries_[s].ray.cross(dx, dy) - 1;
+    return lo >= 0 && hi >= 0;
+  }
+
+  Color colorAt(int32_t dx, int32_t dy) const {
+    int32_t r2 = dx * dx + dy * dy;
+    int32_t coverage = DiscCoverage(r2, r_out_) - DiscCoverage(r2, r_rim_);
+    if (coverage <= 0) return color::Transparent;
+    int s;
+    if (full_circle_) {
+      s = segmentAt(dx, dy);
+    } else {
+      int32_t cs = start_.cross(dx, dy);
+      int32_t ce = -end_.cross(dx, dy);
+      bool inside = wide_ ? (cs >= 0 || ce >= 0) : (cs >= 0 && ce >= 0);
+      // Distances from the edges. Points behind the center are far away.
+      int32_t ds = start_.dot(dx, dy) > 0 ? std::abs(cs) : INT32_MAX;
+      int32_t de = end_.dot(dx, dy) > 0 ? std::abs(ce) : INT32_MAX;
+      int32_t d = std::min(ds, de);
+      coverage = coverage * EdgeCoverage(inside ? d : -d) >> 8;
+      if (coverage == 0) return color::Transparent;
+      s = inside ? segmentAt(dx, dy) : (ds <= de ? 0 : colors_.size() - 1);
+    }
+    Color c = (r2 < r_in_sq_) ? color::Black : colors_[s];
+    if (coverage < 256) c.set_a((uint8_t)((c.a() * coverage + 128) >> 8));
+    return c;
+  }
+
+  int16_t cx_, cy_;
+  int32_t r_rim_, r_in_sq_, r_out_;
+  // Whether the sector is a full circle, so that it has no edges.
+  bool full_circle_;
+  // Whether the sector spans at least a half-turn.
+  bool wide_;
+  Ray start_, end_;
+  // In binary angle units.
+  int32_t segment_span_;
+  // Between consecutive segments; one fewer than the segments.
+  std::vector<Boundary> boundaries_;
+  std::vector<Color> colors_;
+  Box extents_;
+};
+
 class GaugeBase : public Drawable {
  public:
   GaugeBase(const RadialGauge::Spec* spec) : spec_(spec) {}
@@ -49,11 +304,7 @@ class GaugeBase : public Drawable {
 
  private:
   void drawTo(const Surface& s) const override {
-    float scale = spec_->deg_scale_end - spec_->deg_scale_start;
-    float len = scale * (2 * kPi * spec_->radius + spec_->scale_width) / 360.0;
-    int dividers = (int)(len / 3);
-    float deg = spec_->deg_scale_start;
-    Point center = {.x = spec_->x_center, .y = spec_->y_center};
+    PolarPoint center = {.x = spec_->x_center, .y = spec_->y_center};
 
     float first_divider =
         (int)(spec_->min_scale_value /
@@ -64,51 +315,29 @@ class GaugeBase : public Drawable {
               spec_->ticks_per_divider;
     float divider = first_divider;
     while (divider <= spec_->max_scale_value) {
-      float deg = divider / (spec_->max_scale_value - spec_->min_scale_value) *
-                      (spec_->deg_scale_end - spec_->deg_scale_start) +
-                  spec_->deg_scale_start;
-      int out_radius = spec_->radius + spec_->scale_width;
+      BinaryAngle angle = DegToBinaryAngle(scaleDeg(*spec_, divider));
+      int16_t out_radius = spec_->radius + spec_->scale_width;
       if (idx == 0) {
         out_radius += 5;
         const Font& font = font_NotoSans_Condensed_15();
-        TextLabel label(roo_io::StringPrintf("%2.f", divider), font,
-                        color::Black);
-        Point label_pos =
-            polarToCart(deg, out_radius + font.metrics().ascent(), center);
+        TextLabel label(FormattedNumber(divider, kScaleLabelFormat).c_str(),
+                        font, color::Black);
+        PolarPoint label_pos =
+            PolarToCart(angle, out_radius + font.metrics().ascent(), center);
         s.drawObject(label, label_pos.x - label.metrics().width() / 2,
                      label_pos.y + label.metrics().height() / 2);
       } else {
         out_radius -= 5;
       }
-      Point p0 = polarToCart(deg, out_radius, center);
-      Point p1 = polarToCart(deg, spec_->radius, center);
+      PolarPoint p0 = PolarToCart(angle, out_radius, center);
+      PolarPoint p1 = PolarToCart(angle, spec_->radius, center);
       s.drawObject(Line(p0.x, p0.y, p1.x, p1.y, color::Black));
       divider += (spec_->divider_spacing / spec_->ticks_per_divider);
       idx++;
       if (idx >= spec_->ticks_per_divider) idx = 0;
     }
 
-    Point p0 = polarToCart(deg, spec_->radius + spec_->scale_width, center);
-    Point p1 = polarToCart(deg, spec_->radius, center);
-    float value = spec_->min_scale_value;
-    for (int i = 1; i <= dividers; ++i) {
-      float new_deg = spec_->deg_scale_start + (scale * i) / dividers;
-      Point new_p0 =
-          polarToCart(new_deg, spec_->radius + spec_->scale_width, center);
-      Point new_p1 = polarToCart(new_deg, spec_->radius, center);
-      float new_value =
-          spec_->min_scale_value +
-          (i * (spec_->max_scale_value - spec_->min_scale_value) / dividers);
-      s.drawObject(Line(p1.x, p1.y, new_p1.x, new_p1.y, color::Black));
-      s.drawObject(FilledTriangle(p0.x, p0.y, p1.x, p1.y, new_p0.x, new_p0.y,
-                                  spec_->scale_color(value)));
-      s.drawObject(FilledTriangle(new_p1.x, new_p1.y, p1.x, p1.y, new_p0.x,
-                                  new_p0.y, spec_->scale_color(value)));
-      p0 = new_p0;
-      p1 = new_p1;
-      deg = new_deg;
-      value = new_value;
-    }
+    s.drawObject(ScaleBand(*spec_));
   }
 
   const RadialGauge::Spec* spec_;
@@ -116,26 +345,190 @@ class GaugeBase : public Drawable {
 
 class Needle : public Drawable {
  public:
-  Needle(Point center, int16_t full_radius, int16_t thick_radius, float deg,
-         Color color)
+  Needle(PolarPoint center, int16_t full_radius, int16_t thick_radius,
+         BinaryAngle angle, Color color)
       : center_{(float)center.x, (float)center.y},
-        tip_(polarToCartFp(deg, full_radius - 1, center_)),
+        tip_(polarToCartFp(angle, full_radius - 1, center_)),
         color_(color) {}
 
   Box extents() const {
     return SmoothWedgedLine(center_, 15, tip_, 0, color_).extents();
   }
 
+  const FpPoint& center() const { return center_; }
+  const FpPoint& tip() const { return tip_; }
+
  private:
   void drawTo(const Surface& s) const override {
     s.drawObject(SmoothWedgedLine(center_, 15, tip_, 0, color_));
   }
 
-  Point p0_, p1_, p2_, p3_, p4_;
   FpPoint center_, tip_;
   Color color_;
 };
 
+// Half of the needle width at the center.
+static constexpr float kNeedleHalfWidth = 7.5f;
+
+// Margin that accounts for anti-aliasing and for the sub-pixel convention,
+// when approximating the needle outline.
+static constexpr float kNeedleFringe = 1.5f;
+
+// Conservative approximations of the needle wedge (the convex hull of a disc
+// around the center and a point at the tip), used to figure out which pixels
+// need to be restored when the needle moves. Both are convex quadrilaterals:
+// 'outer' contains every pixel that the needle may touch, including its
+// anti-aliased fringe, and 'inner' contains only pixels that the needle fully
+// covers.
+class NeedleOutline {
+ public:
+  NeedleOutline(const Needle& needle) {
+    FpPoint c0 = needle.center();
+    FpPoint c1 = needle.tip();
+    float dx = c1.x - c0.x;
+    float dy = c1.y - c0.y;
+    float len = sqrtf(dx * dx + dy * dy);
+    if (len > 0) {
+      dx /= len;
+      dy /= len;
+    }
+    // (nx, ny) is perpendicular to the needle.
+    float nx = -dy;
+    float ny = dx;
+    float r0 = kNeedleHalfWidth + kNeedleFringe;
+    float r1 = kNeedleFringe;
+    outer_[0] = FpPoint{c0.x - (dx - nx) * r0, c0.y - (dy - ny) * r0};
+    outer_[1] = FpPoint{c1.x + (dx + nx) * r1, c1.y + (dy + ny) * r1};
+    outer_[2] = FpPoint{c1.x + (dx - nx) * r1, c1.y + (dy - ny) * r1};
+    outer_[3] = FpPoint{c0.x - (dx + nx) * r0, c0.y - (dy + ny) * r0};
+    r0 = kNeedleHalfWidth - kNeedleFringe;
+    inner_[0] = FpPoint{c0.x + nx * r0, c0.y + ny * r0};
+    inner_[1] = c1;
+    inner_[2] = c1;
+    inner_[3] = FpPoint{c0.x - nx * r0, c0.y - ny * r0};
+  }
+
+  // Returns the range of columns in the row y that the needle may touch.
+  bool outerSpan(int16_t y, int16_t* x_min, int16_t* x_max) const {
+    float lo, hi;
+    if (!stripRange(outer_, y, y + 1, &lo, &hi)) return false;
+    *x_min = (int16_t)floorf(lo);
+    *x_max = (int16_t)ceilf(hi) - 1;
+    return true;
+  }
+
+  // Returns the range of columns in the row y that the needle fully covers.
+  bool innerSpan(int16_t y, int16_t* x_min, int16_t* x_max) const {
+    float lo0, hi0, lo1, hi1;
+    if (!lineRange(inner_, y, &lo0, &hi0)) return false;
+    if (!lineRange(inner_, y + 1, &lo1, &hi1)) return false;
+    *x_min = (int16_t)ceilf(std::max(lo0, lo1));
+    *x_max = (int16_t)floorf(std::min(hi0, hi1)) - 1;
+    return *x_min <= *x_max;
+  }
+
+ private:
+  // Computes the intersection of the polygon with the horizontal line.
+  static bool lineRange(const FpPoint* poly, float y, float* lo, float* hi) {
+    bool found = false;
+    for (int i = 0; i < 4; ++i) {
+      const FpPoint& a = poly[i];
+      const FpPoint& b = poly[(i + 1) % 4];
+      if ((a.y - y) * (b.y - y) > 0) continue;
+      float x0, x1;
+      if (a.y == b.y) {
+        x0 = std::min(a.x, b.x);
+        x1 = std::max(a.x, b.x);
+      } else {
+        x0 = x1 = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+      }
+      if (!found) {
+        *lo = x0;
+        *hi = x1;
+        found = true;
+      } else {
+        *lo = std::min(*lo, x0);
+        *hi = std::max(*hi, x1);
+      }
+    }
+    return found;
+  }
+
+  // Computes the horizontal extent of the polygon within the [y0, y1] strip.
+  static bool stripRange(const FpPoint* poly, float y0, float y1, float* lo,
+                         float* hi) {
+    bool found = false;
+    float l, h;
+    if (lineRange(poly, y0, &l, &h)) {
+      *lo = l;
+      *hi = h;
+      found = true;
+    }
+    if (lineRange(poly, y1, &l, &h)) {
+      *lo = found ? std::min(*lo, l) : l;
+      *hi = found ? std::max(*hi, h) : h;
+      found = true;
+    }
+    for (int i = 0; i < 4; ++i) {
+      const FpPoint& v = poly[i];
+      if (v.y < y0 || v.y > y1) continue;
+      *lo = found ? std::min(*lo, v.x) : v.x;
+      *hi = found ? std::max(*hi, v.x) : v.x;
+      found = true;
+    }
+    return found;
+  }
+
+  FpPoint outer_[4];
+  FpPoint inner_[4];
+};
+
+// Calls fn(y, x_min, x_max) for each horizontal span of pixels, within the
+// bounds, that the old needle may have touched, and that the new needle does
+// not certainly overwrite.
+template <typename Fn>
+void forEachSweptSpan(const NeedleOutline& old_outline,
+                      const NeedleOutline& new_outline, const Box& bounds,
+                      Fn&& fn) {
+  for (int16_t y = bounds.yMin(); y <= bounds.yMax(); ++y) {
+    int16_t x0, x1;
+    if (!old_outline.outerSpan(y, &x0, &x1)) continue;
+    x0 = std::max(x0, bounds.xMin());
+    x1 = std::min(x1, bounds.xMax());
+    if (x0 > x1) continue;
+    int16_t i0, i1;
+    if (!new_outline.innerSpan(y, &i0, &i1) || i1 < x0 || i0 > x1) {
+      fn(y, x0, x1);
+      continue;
+    }
+    if (x0 < i0) fn(y, x0, (int16_t)(i0 - 1));
+    if (x1 > i1) fn(y, (int16_t)(i1 + 1), x1);
+  }
+}
+
+// The static part of the gauge: the face, and the scale under it, drawn front
+// to back, as paint() does. Used to populate the scale cache.
+class ScaleLayer : public Drawable {
+ public:
+  ScaleLayer(const RadialGauge::Spec* spec, const Drawable* face,
+             Offset face_offset)
+      : base_(spec), face_(face), face_offset_(face_offset) {}
+
+  Box extents() const override { return base_.extents(); }
+
+ private:
+  void drawTo(const Surface& s) const override {
+    if (face_ != nullptr) {
+      s.drawObject(*face_, face_offset_.dx, face_offset_.dy);
+    }
+    s.drawObject(base_);
+  }
+
+  GaugeBase base_;
+  const Drawable* face_;
+  Offset face_offset_;
+};
+
 }  // namespace
 
 Dimensions RadialGauge::getSuggestedMinimumDimensions() const {
@@ -144,7 +537,8 @@ Dimensions RadialGauge::getSuggestedMinimumDimensions() const {
 }
 
 void RadialGauge::paintWidgetContents(const Canvas& canvas, Clipper& clipper) {
-  Widget::paintWidgetContents(canvas, clipper);
+  ROO_DASHBOARD_PAINT_STATS_SCOPE("RadialGauge", canvas, counted_canvas);
+  Widget::paintWidgetContents(counted_canvas, clipper);
   previous_value_ = current_value_;
 }
 
@@ -166,29 +560,48 @@ void RadialGauge::paint(const Canvas& canvas) const {
     dc.setWriteOnce();
     dc.draw(
         FilledCircle::ByRadius(spec_.x_center, spec_.y_center, 7, color::Red));
-    if (face_ != nullptr) {
-      dc.draw(*face_, center);
+    if (scale_cache_enabled_) {
+      if (scale_cache_stale_) {
+        Offset face_offset{0, 0};
+        if (face_ != nullptr) {
+          face_offset =
+              center.resolveOffset(bounds().asBox(), face_->anchorExtents());
+        }
+        // If the capture fails (too many colors), the cache stays empty, and
+        // we fall back to drawing directly until the spec changes.
+        scale_cache_.capture(ScaleLayer(&spec_, face_, face_offset),
+                             base.extents());
+        scale_cache_stale_ = false;
+      }
+    }
+    if (!scale_cache_.empty()) {
+      dc.draw(scale_cache_);
+    } else {
+      if (face_ != nullptr) {
+        dc.draw(*face_, center);
+      }
+      dc.draw(base);
     }
-    dc.draw(base);
-    Needle needle(Point{.x = spec_.x_center, .y = spec_.y_center},
-                  needle_radius, needle_radius - 8, currentDeg(), color::Red);
+    Needle needle(PolarPoint{.x = spec_.x_center, .y = spec_.y_center},
+                  needle_radius, needle_radius - 8, currentAngle(), color::Red);
     dc.draw(needle);
   } else {
     if (previous_value_ == current_value_) return;
-    Needle old_needle(Point{.x = spec_.x_center, .y = spec_.y_center},
-                      needle_radius, needle_radius - 8, previousDeg(),
+    Needle old_needle(PolarPoint{.x = spec_.x_center, .y = spec_.y_center},
+                      needle_radius, needle_radius - 8, previousAngle(),
                       color::Red);
-    Needle needle(Point{.x = spec_.x_center, .y = spec_.y_center},
-                  needle_radius, needle_radius - 8, currentDeg(), color::Red);
+    Needle needle(PolarPoint{.x = spec_.x_center, .y = spec_.y_center},
+                  needle_radius, needle_radius - 8, currentAngle(), color::Red);
     {
       DrawingContext dc(my_canvas);
       dc.setFillMode(roo_display::FillMode::kVisible);
       dc.draw(needle);
     }
     Box extents = old_needle.extents();
-    roo_display::BitMaskOffscreen bitmask(extents, color::Black);
+    roo_display::BitMaskOffscreen bitmask(extents, needleMaskBuffer(extents));
 
     DrawingContext mask_dc(bitmask);
+    mask_dc.fill(color::Black);
     // Erase the old needle from the mask.
     mask_dc.erase(old_needle);
     // But mask back the new needle as we don't want it overwritten.
@@ -198,45 +611,157 @@ void RadialGauge::paint(const Canvas& canvas) const {
         FilledCircle::ByRadius(spec_.x_center, spec_.y_center, 7, color::Red));
 
     // Now, the clip mask passes the pixels of the old needle that are not
-    // obstructed by the new needle.
+    // obstructed by the new needle. To avoid needlessly processing the entire
+    // bounding box of the old needle, we further restrict the redraw to the
+    // spans that the old needle may have touched, minus the spans that the new
+    // needle certainly covers.
+    NeedleOutline old_outline(old_needle);
+    NeedleOutline new_outline(needle);
+    Box dirty(0, 0, -1, -1);
+    forEachSweptSpan(old_outline, new_outline, extents,
+                     [&dirty](int16_t y, int16_t x0, int16_t x1) {
+                       Box span(x0, y, x1, y);
+                       dirty = dirty.empty() ? span : Box::Extent(dirty, span);
+                     });
+    if (dirty.empty()) return;
     ClipMask mask(bitmask.buffer(),
                   bitmask.extents().translate(my_canvas.dx(), my_canvas.dy()));
     ClipMaskFilter filter(canvas.out(), &mask);
     my_canvas.set_out(&filter);
     if (face_ != nullptr) {
       auto offset =
-          center.resolveOffset(Box(0, 0, 159, 127), face_->anchorExtents());
-      DrawingContext dc(my_canvas);
+          center.resolveOffset(bounds().asBox(), face_->anchorExtents());
+      Canvas face_canvas(my_canvas);
+      face_canvas.clipToExtents(dirty);
+      DrawingContext dc(face_canvas);
       dc.draw(*face_, center);
       mask_dc.draw(*face_, offset.dx, offset.dy);
     }
-    my_canvas.clearRect(extents);
+    forEachSweptSpan(old_outline, new_outline, extents,
+                     [&my_canvas](int16_t y, int16_t x0, int16_t x1) {
+                       my_canvas.clearRect(Box(x0, y, x1, y));
+                     });
   }
 }
 
 void RadialGauge::setValue(float value) {
+  if (animator_.enabled()) {
+    animator_.setTarget(value);
+    // Unless it jumped straight to the target.
+    if (animator_.isAnimating()) return;
+  }
+  showValue(value);
+}
+
+void RadialGauge::setAnimation(const AnimationSpec& spec) {
+  // Finish any animation in progress.
+  float target = targetValue();
+  animator_.setSpec(spec);
+  animator_.jumpTo(target);
+  showValue(target);
+}
+
+bool RadialGauge::animate(roo_time::Uptime now) {
+  if (animator_.step(now)) showValue(animator_.value());
+  return animator_.isAnimating();
+}
+
+void RadialGauge::showValue(float value) {
+  // The needle has no position for NaN; keep the last one.
+  if (std::isnan(value)) return;
   if (current_value_ == value) return;
+  int32_t key = needleKey(value);
   current_value_ = value;
+  if (key == needle_key_) {
+    // The needle would be rendered the same; don't bother repainting. (The
+    // value is still stored, so that a spec change positions the needle
+    // according to the last value set.)
+    ++suppressed_updates_;
+    return;
+  }
+  needle_key_ = key;
   setDirty();
 }
 
+void RadialGauge::setScaleCacheEnabled(bool enabled) {
+  if (scale_cache_enabled_ == enabled) return;
+  scale_cache_enabled_ = enabled;
+  scale_cache_.clear();
+  scale_cache_stale_ = true;
+}
+
+void RadialGauge::specChanged() {
+  scale_cache_.clear();
+  scale_cache_stale_ = true;
+  updateNeedleMaskCapacity();
+  needle_key_ = needleKey(current_value_);
+  invalidateInterior();
+}
+
+namespace {
+
+size_t bitMaskSize(const Box& extents) {
+  // Conservatively assume that rows are byte-aligned.
+  return (size_t)((extents.width() + 7) / 8) * extents.height();
+}
+
+}  // namespace
+
+void RadialGauge::updateNeedleMaskCapacity() {
+  // The needle extents are extreme either at the ends of the needle range, or
+  // where the needle crosses one of the axes.
+  int16_t needle_radius = spec_.radius - 2;
+  PolarPoint center{.x = spec_.x_center, .y = spec_.y_center};
+  Box worst = Needle(center, needle_radius, needle_radius - 8,
+                     DegToBinaryAngle(spec_.deg_needle_start), color::Red)
+                  .extents();
+  worst = Box::Extent(worst, Needle(center, needle_radius, needle_radius - 8,
+                                    DegToBinaryAngle(spec_.deg_needle_end),
+                                    color::Red)
+                                 .extents());
+  for (int deg = -360; deg <= 360; deg += 90) {
+    if (deg > spec_.deg_needle_start && deg < spec_.deg_needle_end) {
+      worst = Box::Extent(worst, Needle(center, needle_radius,
+                                        needle_radius - 8,
+                                        DegToBinaryAngle(deg), color::Red)
+                                     .extents());
+    }
+  }
+  size_t size = bitMaskSize(worst);
+  if (size != needle_mask_capacity_) {
+    needle_mask_.reset(new uint8_t[size]);
+    needle_mask_capacity_ = size;
+  }
+}
+
+uint8_t* RadialGauge::needleMaskBuffer(const Box& extents) const {
+  size_t size = bitMaskSize(extents);
+  if (size > needle_mask_capacity_) {
+    // Should not happen, as the capacity is computed for the worst case; but
+    // better safe than sorry.
+    needle_mask_.reset(new uint8_t[size]);
+    needle_mask_capacity_ = size;
+  }
+  return needle_mask_.get();
+}
+
 void RadialGauge::setFace(const roo_display::Drawable* face) {
   if (face_ == face) return;
   face_ = face;
-  invalidateInterior();
+  specChanged();
 }
 
 void RadialGauge::setBounds(const Box& bounds) {
   if (spec_.extents == bounds) return;
   spec_.extents = bounds;
-  invalidateInterior();
+  specChanged();
 }
 
 void RadialGauge::setCenter(int16_t x, int16_t y) {
   if (spec_.x_center == x && spec_.y_center == y) return;
   spec_.x_center = x;
   spec_.y_center = y;
-  invalidateInterior();
+  specChanged();
 }
 
 void RadialGauge::setRangeAngles(float deg_scale_start, float deg_scale_end) {
@@ -256,19 +781,19 @@ void RadialGauge::setRangeAngles(float deg_scale_start, float deg_scale_end,
   spec_.deg_scale_end = deg_scale_end;
   spec_.deg_needle_start = deg_needle_start;
   spec_.deg_needle_end = deg_needle_end;
-  invalidateInterior();
+  specChanged();
 }
 
 void RadialGauge::setScaleRadius(float radius) {
   if (spec_.radius == radius) return;
   spec_.radius = radius;
-  invalidateInterior();
+  specChanged();
 }
 
 void RadialGauge::setScaleWidth(int16_t width) {
   if (spec_.scale_width == width) return;
   spec_.scale_width = width;
-  invalidateInterior();
+  specChanged();
 }
 
 void RadialGauge::setValueRange(float min_scale_value, float max_scale_value) {
@@ -278,7 +803,7 @@ void RadialGauge::setValueRange(float min_scale_value, float max_scale_value) {
   }
   spec_.min_scale_value = min_scale_value;
   spec_.max_scale_value = max_scale_value;
-  invalidateInterior();
+  specChanged();
 }
 
 void RadialGauge::setDividers(float spacing, int16_t subdivision) {
@@ -288,33 +813,46 @@ void RadialGauge::setDividers(float spacing, int16_t subdivision) {
   }
   spec_.divider_spacing = spacing;
   spec_.ticks_per_divider = subdivision;
-  invalidateInterior();
+  specChanged();
 }
 
 void RadialGauge::setScaleColoring(
     std::function<roo_display::Color(float)> coloring) {
   spec_.scale_color = coloring;
-  invalidateInterior();
+  spec_.scale_lut = nullptr;
+  specChanged();
+}
+
+void RadialGauge::setScaleColoring(const GradientLut& lut) {
+  spec_.scale_lut = &lut;
+  specChanged();
 }
 
 namespace {
-float valToDeg(const RadialGauge::Spec& spec, float val) {
-  float deg =
-      spec.deg_scale_start + (val - spec.min_scale_value) /
-                                 (spec.max_scale_value - spec.min_scale_value) *
-                                 (spec.deg_scale_end - spec.deg_scale_start);
+BinaryAngle valToAngle(const RadialGauge::Spec& spec, float val) {
+  float deg = scaleDeg(spec, val);
   if (deg < spec.deg_needle_start) deg = spec.deg_needle_start;
   if (deg > spec.deg_needle_end) deg = spec.deg_needle_end;
-  return deg;
+  return DegToBinaryAngle(deg);
 }
 }  // namespace
 
-float RadialGauge::currentDeg() const {
-  return valToDeg(spec_, current_value_);
+BinaryAngle RadialGauge::currentAngle() const {
+  return valToAngle(spec_, current_value_);
+}
+
+BinaryAngle RadialGauge::previousAngle() const {
+  return valToAngle(spec_, previous_value_);
 }
 
-float RadialGauge::previousDeg() const {
-  return valToDeg(spec_, previous_value_);
+int32_t RadialGauge::needleKey(float value) const {
+  // Needle angle, quantized so that consecutive keys move the needle tip by
+  // 1/4 px (which is about the resolution of the anti-aliased rendering).
+  static constexpr float kStepsPerPixel = 4;
+  int16_t angle = (int16_t)valToAngle(spec_, value);
+  float tip_radius = spec_.radius - 3;
+  return (int32_t)lroundf(angle * (2 * kPi / 65536) * tip_radius *
+                          kStepsPerPixel);
 }
 
-}  // namespace roo_dashboard
\ No newline at end of file
+}  // namespace roo_dashboard
@@ -1,5 +1,11 @@
 #include <cmath>
+#include <memory>
 
+#include "roo_dashboard/core/compressed_raster.h"
+#include "roo_dashboard/core/gradient_lut.h"
+#include "roo_dashboard/core/paint_stats.h"
+#include "roo_dashboard/core/polar.h"
+#include "roo_dashboard/core/value_animator.h"
 #include "roo_display.h"
 #include "roo_display/color/gradient.h"
 #include "roo_display/core/offscreen.h"
@@ -12,12 +18,19 @@
 
 namespace roo_dashboard {
 
+namespace internal {
+inline constexpr GradientStop kDefaultGaugeScaleStops[] = {
+    {0.0, roo_display::color::Red},
+    {40.0, roo_display::color::White},
+    {100.0, roo_display::color::White}};
+}  // namespace internal
+
+// Default coloring of the gauge scale.
+inline constexpr GradientLutTable<64> kDefaultGaugeScaleLut(
+    internal::kDefaultGaugeScaleStops, 0.0, 100.0);
+
 inline roo_display::Color colorForValue(float value) {
-  static roo_display::ColorGradient gradient(
-      {{0.0, roo_display::color::Red},
-       {40.0, roo_display::color::White},
-       {100.0, roo_display::color::White}});
-  return gradient.getColor(value);
+  return kDefaultGaugeScaleLut.getColor(value);
 };
 
 class RadialGauge : public roo_windows::Widget {
@@ -37,6 +50,8 @@ class RadialGauge : public roo_windows::Widget {
     float deg_needle_start;
     float deg_needle_end;
     std::function<roo_display::Color(float)> scale_color;
+    // If not null, used instead of scale_color.
+    const GradientLut* scale_lut;
     int16_t face_x_offset;
     int16_t face_y_offset;
   };
@@ -57,10 +72,19 @@ class RadialGauge : public roo_windows::Widget {
               .deg_needle_start = -55,
               .deg_needle_end = 55,
               .scale_color = &colorForValue,
+              .scale_lut = &kDefaultGaugeScaleLut,
               .face_x_offset = 0,
               .face_y_offset = -80},
+        face_(nullptr),
         current_value_(value),
-        previous_value_(value) {}
+        previous_value_(value),
+        scale_cache_enabled_(false),
+        scale_cache_stale_(true),
+        needle_mask_capacity_(0),
+        suppressed_updates_(0) {
+    updateNeedleMaskCapacity();
+    needle_key_ = needleKey(current_value_);
+  }
 
   roo_windows::Dimensions getSuggestedMinimumDimensions() const override;
 
@@ -69,8 +93,29 @@ class RadialGauge : public roo_windows::Widget {
 
   void paint(const roo_windows::Canvas& canvas) const override;
 
+  // Sets the value indicated by the needle. If the needle would be rendered
+  // the same as it is now (i.e. the change is below the display resolution),
+  // the update is ignored. If animation is enabled, sets the target that the
+  // needle then moves toward, on each animate(). NaN leaves the needle where
+  // it is.
   void setValue(float value);
 
+  // Enables (or, with zero settle_time, disables) animated needle movement.
+  // The animation must then be driven by an AnimationClock.
+  void setAnimation(const AnimationSpec& spec);
+
+  // Advances the needle animation. Returns true while in progress.
+  bool animate(roo_time::Uptime now);
+
+  // The value that the needle shows, or moves toward.
+  float targetValue() const {
+    return animator_.enabled() ? animator_.target() : current_value_;
+  }
+
+  // Returns the number of setValue() calls that have been ignored because they
+  // would not change the rendered needle.
+  uint32_t suppressedUpdates() const { return suppressed_updates_; }
+
   void setFace(const roo_display::Drawable* face);
   void setBounds(const roo_display::Box& bounds);
   void setCenter(int16_t x, int16_t y);
@@ -90,15 +135,62 @@ class RadialGauge : public roo_windows::Widget {
 
   void setScaleColoring(std::function<roo_display::Color(float)> coloring);
 
+  // Sets the scale coloring to the specified lookup table, which must outlive
+  // the gauge. Faster than the function variant.
+  void setScaleColoring(const GradientLut& lut);
+
+  // Enables caching of the pre-rendered face and scale, so that full repaints
+  // (e.g. after a page switch) become a single blit. The cache is rebuilt
+  // lazily, on the first paint after any of the setters above changes the
+  // gauge. Disabled by default, as it costs memory (typically a few KB; see
+  // scaleCacheMemoryUsage()).
+  void setScaleCacheEnabled(bool enabled);
+
+  size_t scaleCacheMemoryUsage() const { return scale_cache_.memoryUsage(); }
+
  private:
-  float currentDeg() const;
-  float previousDeg() const;
+  // Called when anything that affects the face or the scale changes.
+  void specChanged();
+
+  // Moves the needle to the value, unless it would be rendered the same.
+  void showValue(float value);
+
+  // Sizes the needle mask buffer so that it can hold the mask of the needle
+  // at any angle, so that needle updates don't need to allocate memory.
+  void updateNeedleMaskCapacity();
+
+  // Returns the scratch buffer for the needle mask, large enough for the
+  // specified extents.
+  uint8_t* needleMaskBuffer(const roo_display::Box& extents) const;
+
+  BinaryAngle currentAngle() const;
+  BinaryAngle previousAngle() const;
+
+  // Returns the quantized needle position for the specified value. Values
+  // with equal keys render identically.
+  int32_t needleKey(float value) const;
 
   Spec spec_;
   const roo_display::Drawable* face_;
 
   float current_value_;
   float previous_value_;
+
+  bool scale_cache_enabled_;
+  mutable bool scale_cache_stale_;
+  mutable CompressedRaster scale_cache_;
+
+  // Scratch buffer for the clip mask used when erasing the old needle.
+  mutable std::unique_ptr<uint8_t[]> needle_mask_;
+  mutable size_t needle_mask_capacity_;
+
+  // Quantized needle position of current_value_.
+  int32_t needle_key_;
+  uint32_t suppressed_updates_;
+
+  ValueAnimator animator_;
+
+  ROO_DASHBOARD_PAINT_STATS_MEMBER;
 };
 
 }  // namespace roo_dashboard
\ No newline at end of file
@@ -79,3 +79,17 @@ const RleImage4bppxBiased<Alpha4, ProgMemPtr>& thermometer_246x80_bar() {
       38, 212, thermometer_246x80_bar_data, Alpha4(color::Black));
   return value;
 }
+
+// Row index: every 16 rows, 56 bytes.
+static const uint16_t thermometer_246x80_bar_row_index_data[] PROGMEM = {
+  0, 0, 168, 4, 328, 4, 488, 4, 648, 4, 808, 4, 968, 4, 1128, 4, 1288, 4,
+  1448, 4, 1608, 4, 1768, 4, 1931, 1, 2087, 0,
+};
+
+const ::roo_dashboard::RleRowIndex& thermometer_246x80_bar_row_index() {
+  static const ::roo_dashboard::RleRowIndex value{
+      .rows_per_entry = 16,
+      .entry_count = 14,
+      .entries = thermometer_246x80_bar_row_index_data};
+  return value;
+}
@@ -131,3 +131,17 @@ const RleImage4bppxBiased<Alpha4, ProgMemPtr>& thermometer_246x80_bounds() {
       58, 232, thermometer_246x80_bounds_data, Alpha4(color::Black));
   return value;
 }
+
+// Row index: every 16 rows, 60 bytes.
+static const uint16_t thermometer_246x80_bounds_row_index_data[] PROGMEM = {
+  0, 0, 293, 4, 549, 4, 805, 4, 1061, 4, 1317, 4, 1573, 4, 1829, 4, 2085, 4,
+  2341, 4, 2597, 4, 2853, 4, 3125, 2, 3364, 0, 3653, 1,
+};
+
+const ::roo_dashboard::RleRowIndex& thermometer_246x80_bounds_row_index() {
+  static const ::roo_dashboard::RleRowIndex value{
+      .rows_per_entry = 16,
+      .entry_count = 15,
+      .entries = thermometer_246x80_bounds_row_index_data};
+  return value;
+}
@@ -1,3 +1,6 @@
+#include "roo_dashboard/core/indexed_rle_image.h"
 #include "roo_display/image/image.h"
 
 const ::roo_display::RleImage4bppxBiased<::roo_display::Alpha4, ::roo_display::ProgMemPtr>& thermometer_246x80_bounds();
+
+const ::roo_dashboard::RleRowIndex& thermometer_246x80_bounds_row_index();
@@ -0,0 +1,182 @@
+#include "roo_dashboard/meters/stacked_bar.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "roo_display/core/rasterizable.h"
+#include "roo_logging.h"
+
+using namespace roo_display;
+using namespace roo_windows;
+
+namespace roo_dashboard {
+
+namespace {
+
+// All the segments of the bar, followed by the background. The segment
+// color is resolved per span of pixels, rather than per pixel, when filling
+// rectangles.
+class SegmentRaster : public roo_display::Rasterizable {
+ public:
+  // The ends are relative to the left of the extents (which are in device
+  // coordinates), and non-decreasing.
+  SegmentRaster(roo_display::Box extents, const int16_t* ends,
+                const Color* colors, uint8_t count, Color background)
+      : extents_(extents),
+        ends_(ends),
+        colors_(colors),
+        count_(count),
+        background_(background) {}
+
+  void readColors(const int16_t* x, const int16_t* y, uint32_t count,
+                  Color* result) const override {
+    while (count-- > 0) {
+      int16_t pos = *x++ - extents_.xMin();
+      uint8_t segment = 0;
+      while (segment < count_ && pos >= ends_[segment]) ++segment;
+      *result++ = segment < count_ ? colors_[segment] : background_;
+    }
+  }
+
+  bool readColorRect(int16_t xMin, int16_t yMin, int16_t xMax, int16_t yMax,
+                     Color* result) const override {
+    int16_t pos = xMin - extents_.xMin();
+    int16_t last = xMax - extents_.xMin();
+    uint8_t segment = 0;
+    while (segment < count_ && pos >= ends_[segment]) ++segment;
+    if (segment == count_ || ends_[segment] > last) {
+      // Uniform.
+      *result = segment < count_ ? colors_[segment] : background_;
+      return true;
+    }
+    // All rows are the same: uniform spans, one per segment.
+    uint32_t width = xMax - xMin + 1;
+    Color* out = result;
+    while (pos <= last) {
+      int16_t end = segment < count_ ? std::min<int16_t>(ends_[segment],
+                                                         last + 1)
+                                     : last + 1;
+      Color color = segment < count_ ? colors_[segment] : background_;
+      out = std::fill_n(out, end - pos, color);
+      pos = end;
+      ++segment;
+    }
+    for (int16_t y = yMin + 1; y <= yMax; ++y) {
+      std::copy_n(result, width, result + width * (y - yMin));
+    }
+    return false;
+  }
+
+  roo_display::Box extents() const override { return extents_; }
+
+ private:
+  roo_display::Box extents_;
+  const int16_t* ends_;
+  const Color* colors_;
+  uint8_t count_;
+  Color background_;
+};
+
+// Drops the colors past kMaxSegments, so that segment indexes fit in uint8_t.
+std::vector<Color> limitSegments(std::vector<Color> colors) {
+  if (colors.size() > StackedBar::kMaxSegments) {
+    LOG(WARNING) << "StackedBar supports at most "
+                 << (int)StackedBar::kMaxSegments << " segments; got "
+                 << colors.size();
+    colors.resize(StackedBar::kMaxSegments);
+  }
+  return colors;
+}
+
+}  // namespace
+
+StackedBar::StackedBar(const roo_windows::Environment& env, float scale,
+                       std::vector<Color> segment_colors)
+    : roo_windows::Widget(env),
+      scale_(scale),
+      colors_(limitSegments(std::move(segment_colors))),
+      values_(colors_.size(), 0.0f),
+      ends_(colors_.size(), 0),
+      painted_ends_(colors_.size(), 0),
+      blended_colors_(colors_.size()) {}
+
+void StackedBar::setValue(uint8_t segment, float value) {
+  if (segment >= segmentCount()) return;
+  if (!(value > 0)) value = 0;
+  if (values_[segment] == value) return;
+  values_[segment] = value;
+  updateEnds();
+}
+
+void StackedBar::setValues(const float* values) {
+  for (uint8_t i = 0; i < segmentCount(); ++i) {
+    values_[i] = values[i] > 0 ? values[i] : 0;
+  }
+  updateEnds();
+}
+
+void StackedBar::setSegmentColor(uint8_t segment, Color color) {
+  if (segment >= segmentCount() || colors_[segment] == color) return;
+  colors_[segment] = color;
+  invalidateInterior();
+}
+
+void StackedBar::updateEnds() {
+  float sum = 0;
+  bool changed = false;
+  for (uint8_t i = 0; i < segmentCount(); ++i) {
+    sum += values_[i];
+    int16_t end = (int16_t)std::min(sum * scale_, 32767.0f);
+    if (end != ends_[i]) {
+      ends_[i] = end;
+      changed = true;
+    }
+  }
+  if (changed) setDirty();
+}
+
+void StackedBar::paintWidgetContents(const Canvas& canvas, Clipper& clipper) {
+  ROO_DASHBOARD_PAINT_STATS_SCOPE("StackedBar", canvas, counted_canvas);
+  for (uint8_t i = 0; i < segmentCount(); ++i) {
+    blended_colors_[i] = AlphaBlend(canvas.bgcolor(), colors_[i]);
+  }
+  Widget::paintWidgetContents(counted_canvas, clipper);
+  painted_ends_ = ends_;
+}
+
+void StackedBar::paint(const Canvas& canvas) const {
+  SegmentRaster raster(Box(canvas.dx(), canvas.dy(), canvas.dx() + width() - 1,
+                           canvas.dy() + height() - 1),
+                       ends_.data(), blended_colors_.data(), segmentCount(),
+                       canvas.bgcolor());
+  if (isInvalidated()) {
+    canvas.drawObject(raster);
+    return;
+  }
+  // Repaint the spans between the old and the new ends of the segments,
+  // merging the ones that touch. Both the old and the new ends are
+  // non-decreasing, so the spans come (nearly) in order.
+  LinearSpan pending{0, -1};
+  for (uint8_t i = 0; i <= segmentCount(); ++i) {
+    LinearSpan span{0, -1};
+    if (i < segmentCount()) {
+      span = LinearSpan{std::min(ends_[i], painted_ends_[i]),
+                        (int16_t)(std::max(ends_[i], painted_ends_[i]) - 1)};
+      if (span.empty()) continue;
+      if (!pending.empty() && span.min <= pending.max + 1) {
+        pending.min = std::min(pending.min, span.min);
+        pending.max = std::max(pending.max, span.max);
+        continue;
+      }
+    }
+    if (!pending.empty()) {
+      Canvas my_canvas = canvas;
+      my_canvas.clipToExtents(
+          HorizontalOrientation::ToRect(pending, width(), height()));
+      my_canvas.drawObject(raster);
+    }
+    pending = span;
+  }
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "roo_dashboard/core/linear_meter.h"
+#include "roo_dashboard/core/paint_stats.h"
+#include "roo_display/color/color.h"
+#include "roo_windows/core/canvas.h"
+#include "roo_windows/core/preferred_size.h"
+#include "roo_windows/core/widget.h"
+
+namespace roo_dashboard {
+
+// A single horizontal bar showing several non-negative values (e.g., the
+// power of each phase) as consecutive segments, each in its own color.
+//
+// All segments are rasterized in a single pass. When values change, only the
+// spans between the old and the new segment boundaries get repainted.
+class StackedBar : public roo_windows::Widget {
+ public:
+  // Maximum number of segments.
+  static constexpr uint8_t kMaxSegments = 255;
+
+  // The scale is in pixels per unit of the values. There is one segment for
+  // each color, in order from the left. All values start at zero. Colors past
+  // kMaxSegments are ignored, with a warning.
+  StackedBar(const roo_windows::Environment& env, float scale,
+             std::vector<roo_display::Color> segment_colors);
+
+  uint8_t segmentCount() const { return colors_.size(); }
+
+  // Returns NaN if the segment is out of range.
+  float value(uint8_t segment) const {
+    return segment < segmentCount() ? values_[segment] : std::nanf("");
+  }
+
+  // Negative and NaN values are treated as zero. Out-of-range segments are
+  // ignored (here, and in setSegmentColor()).
+  void setValue(uint8_t segment, float value);
+
+  // Sets the values of all the segments (segmentCount() of them).
+  void setValues(const float* values);
+
+  void setSegmentColor(uint8_t segment, roo_display::Color color);
+
+  roo_windows::Dimensions getSuggestedMinimumDimensions() const override {
+    return roo_windows::Dimensions(50, 10);
+  }
+
+  roo_windows::PreferredSize getPreferredSize() const override {
+    using roo_windows::PreferredSize;
+    return PreferredSize(PreferredSize::MatchParentWidth(),
+                         PreferredSize::WrapContentHeight());
+  }
+
+  void paintWidgetContents(const roo_windows::Canvas& canvas,
+                           roo_windows::Clipper& clipper) override;
+
+  void paint(const roo_windows::Canvas& canvas) const override;
+
+ private:
+  // Recalculates the segment ends from the values; marks dirty if changed.
+  void updateEnds();
+
+  float scale_;
+  std::vector<roo_display::Color> colors_;
+  std::vector<float> values_;
+
+  // Ends of the segments (exclusive, in pixels from the left), currently,
+  // and as of the last paint.
+  std::vector<int16_t> ends_;
+  std::vector<int16_t> painted_ends_;
+
+  // Segment colors, alpha-blended over the background; updated before each
+  // paint.
+  std::vector<roo_display::Color> blended_colors_;
+
+  ROO_DASHBOARD_PAINT_STATS_MEMBER;
+};
+
+}  // namespace roo_dashboard
@@ -0,0 +1,83 @@
+#include "roo_dashboard/meters/strip_chart.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace roo_display;
+using namespace roo_windows;
+
+namespace roo_dashboard {
+
+StripChart::StripChart(const roo_windows::Environment& env, uint16_t capacity,
+                       float min_value, float max_value)
+    : roo_windows::Widget(env),
+      layout_(capacity),
+      samples_(new float[layout_.capacity()]),
+      count_(0),
+      painted_count_(0),
+      min_value_(min_value),
+      max_value_(max_value),
+      color_(env.theme().color.secondary) {}
+
+void StripChart::addSample(float value) {
+  samples_[layout_.slot(count_)] = value;
+  ++count_;
+  setDirty();
+}
+
+void StripChart::clear() {
+  count_ = 0;
+  invalidateInterior();
+}
+
+void StripChart::setRange(float min_value, float max_value) {
+  if (min_value_ == min_value && max_value_ == max_value) return;
+  min_value_ = min_value;
+  max_value_ = max_value;
+  invalidateInterior();
+}
+
+void StripChart::setColor(Color color) {
+  if (color_ == color) return;
+  color_ = color;
+  invalidateInterior();
+}
+
+void StripChart::paintWidgetContents(const Canvas& canvas, Clipper& clipper) {
+  ROO_DASHBOARD_PAINT_STATS_SCOPE("StripChart", canvas, counted_canvas);
+  Widget::paintWidgetContents(counted_canvas, clipper);
+  painted_count_ = count_;
+}
+
+void StripChart::paint(const Canvas& canvas) const {
+  auto paint_column = [&](uint16_t slot) { paintColumn(canvas, slot); };
+  bool full =
+      layout_.repaint(isInvalidated(), painted_count_, count_, paint_column);
+  if (full && layout_.capacity() < width()) {
+    canvas.clearRect(layout_.capacity(), 0, width() - 1, height() - 1);
+  }
+}
+
+void StripChart::paintColumn(const Canvas& canvas, uint16_t slot) const {
+  XDim x = slot;
+  if (x >= width()) return;
+  uint32_t age = layout_.age(slot, count_);
+  if (!layout_.isShown(age, count_) || std::isnan(samples_[slot])) {
+    canvas.clearRect(x, 0, x, height() - 1);
+    return;
+  }
+  // Connect to the previous sample, unless it is not shown.
+  int16_t y1 = toRow(samples_[slot]);
+  int16_t y0 = y1;
+  uint16_t previous = (slot + layout_.capacity() - 1) % layout_.capacity();
+  if (layout_.isShown(age + 1, count_) && !std::isnan(samples_[previous])) {
+    y0 = toRow(samples_[previous]);
+  }
+  int16_t y_min = std::min(y0, y1);
+  int16_t y_max = std::max(y0, y1);
+  if (y_min > 0) canvas.clearRect(x, 0, x, y_min - 1);
+  canvas.fillRect(x, y_min, x, y_max, AlphaBlend(canvas.bgcolor(), color_));
+  if (y_max < height() - 1) canvas.clearRect(x, y_max + 1, x, height() - 1);
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "roo_dashboard/core/paint_stats.h"
+#include "roo_dashboard/core/sweep_layout.h"
+#include "roo_display/color/color.h"
+#include "roo_windows/core/canvas.h"
+#include "roo_windows/core/widget.h"
+
+namespace roo_dashboard {
+
+// Recent history of a value, as a trace, one pixel column per sample.
+//
+// The samples are kept in a fixed-capacity ring buffer, and drawn in 'sweep'
+// mode (see SweepLayout), so that adding a sample repaints just a few
+// columns, i.e. O(height) pixels, rather than the whole chart.
+class StripChart : public roo_windows::Widget {
+ public:
+  // Width of the blank gap ahead of the newest sample, in columns.
+  static constexpr uint16_t kGapColumns = SweepLayout::kGapColumns;
+
+  // The capacity is the number of samples (and columns) of the chart; it
+  // must be larger than kGapColumns. The values are plotted between
+  // min_value (at the bottom) and max_value (at the top), and clamped to
+  // that range.
+  StripChart(const roo_windows::Environment& env, uint16_t capacity,
+             float min_value, float max_value);
+
+  // NaN values show as blank columns.
+  void addSample(float value);
+
+  // Removes all samples.
+  void clear();
+
+  void setRange(float min_value, float max_value);
+
+  void setColor(roo_display::Color color);
+
+  uint16_t capacity() const { return layout_.capacity(); }
+
+  // Total number of samples added (since construction, or clear()).
+  uint32_t sampleCount() const { return count_; }
+
+  roo_windows::Dimensions getSuggestedMinimumDimensions() const override {
+    return roo_windows::Dimensions(layout_.capacity(), 20);
+  }
+
+  void paintWidgetContents(const roo_windows::Canvas& canvas,
+                           roo_windows::Clipper& clipper) override;
+
+  void paint(const roo_windows::Canvas& canvas) const override;
+
+ private:
+  // Maps the value to the row.
+  int16_t toRow(float value) const {
+    return ValueToRow(value, min_value_, max_value_, height());
+  }
+
+  // Paints the column of the specified slot of the ring buffer.
+  void paintColumn(const roo_windows::Canvas& canvas, uint16_t slot) const;
+
+  SweepLayout layout_;
+  std::unique_ptr<float[]> samples_;
+
+  // Sample n is stored in slot layout_.slot(n).
+  uint32_t count_;
+
+  // As of the last paint.
+  uint32_t painted_count_;
+
+  float min_value_;
+  float max_value_;
+  roo_display::Color color_;
+
+  ROO_DASHBOARD_PAINT_STATS_MEMBER;
+};
+
+}  // namespace roo_dashboard
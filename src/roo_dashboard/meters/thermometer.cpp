@@ -1,10 +1,13 @@
 #include "thermometer.h"
 
-#include "roo_dashboard/meters/resources/thermometer_246x80_bar.h"
-#include "roo_dashboard/meters/resources/thermometer_246x80_bounds.h"
+#include <algorithm>
+
+#include "roo_dashboard/core/indexed_rle_image.h"
+#include "roo_dashboard/core/number_format.h"
 #include "roo_display/color/color.h"
 #include "roo_display/shape/basic.h"
 #include "roo_display/ui/string_printer.h"
+#include "roo_logging.h"
 #include "roo_smooth_fonts/NotoSans_Regular/27.h"
 
 using namespace roo_display;
@@ -13,85 +16,206 @@ using namespace roo_windows;
 namespace roo_dashboard {
 
 namespace {
-// Default gradient for the thermometer.
-const roo_display::ColorGradient& getDefaultColorGradient() {
-  static roo_display::ColorGradient gradient({
-      {0.0, Color(0, 0, 0)},         // Black.
-      {12.0, Color(94, 94, 255)},    // Purplish blue.
-      {22.0, Color(153, 195, 255)},  // Light blue.
-      {23.0, Color(255, 207, 94)},   // Yellow.
-      {30.0, Color(255, 31, 31)},    // Red.
-      {40.0, Color(133, 0, 0)},      // Dark red.
-  });
-  return gradient;
-}
+// Default gradient for the thermometer, precomputed at 0.16 deg C resolution.
+constexpr GradientStop kDefaultGradientStops[] = {
+    {0.0, Color(0, 0, 0)},         // Black.
+    {12.0, Color(94, 94, 255)},    // Purplish blue.
+    {22.0, Color(153, 195, 255)},  // Light blue.
+    {23.0, Color(255, 207, 94)},   // Yellow.
+    {30.0, Color(255, 31, 31)},    // Red.
+    {40.0, Color(133, 0, 0)},      // Dark red.
+};
+
+constexpr GradientLutTable<256> kDefaultGradientLut(kDefaultGradientStops, 0.0,
+                                                    40.0);
+
+const NumberFormat kCaptionFormat{.precision = 1, .suffix = "°C"};
 }  // namespace
 
 void Thermometer::Indicator::setTemperature(float tempC) {
+  temp_c_ = tempC;
   if (std::isnan(tempC)) {
-    temp_height_pixels_ = 124;
+    // Show the (disabled) level at 20 deg C, as the original, fixed-scale
+    // thermometer did.
+    temp_height_pixels_ = rowForTemperature(20.0f);
     setEnabled(false);
     return;
   }
   // If we were nan (disabled) before, this will also make us dirty.
   setEnabled(true);
-  // We have 20°C at height 124.
-  int16_t new_height_pixels = 124 - (int)((tempC - 20.0) * 10);
+  int16_t new_height_pixels = rowForTemperature(tempC);
   if (new_height_pixels != temp_height_pixels_) {
     temp_height_pixels_ = new_height_pixels;
-    temp_color_ = temperature_gradient_.getColor(tempC);
+    temp_color_ = temperature_lut_ != nullptr
+                      ? temperature_lut_->getColor(tempC)
+                      : temperature_gradient_->getColor(tempC);
     setDirty();
   }
 }
 
+void Thermometer::Indicator::setArtwork(const ThermometerArtwork& artwork) {
+  if (artwork_ == &artwork) return;
+  artwork_ = &artwork;
+  updateTicks();
+  temp_height_pixels_ = -1;
+  setTemperature(temp_c_);
+  requestLayout();
+  invalidateInterior();
+}
+
+void Thermometer::Indicator::setScale(float min_temp, float max_temp,
+                                      float tick_spacing) {
+  if (min_temp_ == min_temp && max_temp_ == max_temp &&
+      tick_spacing_ == tick_spacing) {
+    return;
+  }
+  // Written to also reject NaNs.
+  if (!(min_temp < max_temp) || !(tick_spacing > 0)) {
+    LOG(WARNING) << "Invalid thermometer scale: " << min_temp << " - "
+                 << max_temp << ", ticks every " << tick_spacing;
+    return;
+  }
+  min_temp_ = min_temp;
+  max_temp_ = max_temp;
+  tick_spacing_ = tick_spacing;
+  updateTicks();
+  temp_height_pixels_ = -1;
+  setTemperature(temp_c_);
+  invalidateInterior();
+}
+
+void Thermometer::Indicator::TickLayer::reset(int16_t x, int16_t height) {
+  x_ = x;
+  rows_.assign(height, 0);
+}
+
+void Thermometer::Indicator::TickLayer::addTick(int16_t row, int16_t length) {
+  if (row >= 0 && row < (int16_t)rows_.size()) rows_[row] = length;
+  if (row + 1 >= 0 && row + 1 < (int16_t)rows_.size()) {
+    rows_[row + 1] = length | 0x80;
+  }
+}
+
+bool Thermometer::Indicator::TickLayer::getSpan(int16_t row, int16_t& col_min,
+                                                int16_t& col_max,
+                                                Color& color) const {
+  uint8_t tick = rows_[row];
+  if (tick == 0) return false;
+  col_min = x_;
+  col_max = x_ + (tick & 0x7F) - 1;
+  color = (tick & 0x80) ? color::LightGray : color::Black;
+  return true;
+}
+
+void Thermometer::Indicator::updateTicks() {
+  const ThermometerArtwork& art = *artwork_;
+  ticks_.reset(art.tick_x, art.bounds.height);
+  // Denser ticks would merge into a solid block anyway (and, in extreme
+  // cases, overflow the counters below).
+  if (!((max_temp_ - min_temp_) / tick_spacing_ <= art.bounds.height)) return;
+  int32_t k_min = (int32_t)ceilf(min_temp_ / tick_spacing_ - 0.001f);
+  int32_t k_max = (int32_t)floorf(max_temp_ / tick_spacing_ + 0.001f);
+  for (int32_t k = k_min; k <= k_max; ++k) {
+    int16_t length = art.tick_lengths[0];
+    if (k % 20 == 0) {
+      length = art.tick_lengths[3];
+    } else if (k % 10 == 0) {
+      length = art.tick_lengths[2];
+    } else if (k % 2 == 0) {
+      length = art.tick_lengths[1];
+    }
+    ticks_.addTick(art.bar_y + rowForTemperature(k * tick_spacing_) + 1,
+                   length);
+  }
+}
+
+int16_t Thermometer::Indicator::rowForTemperature(float tempC) const {
+  const ThermometerArtwork& art = *artwork_;
+  float px_per_deg =
+      (art.scale_bottom_row - art.scale_top_row) / (max_temp_ - min_temp_);
+  float row = art.scale_top_row + (max_temp_ - tempC) * px_per_deg;
+  // Clamp, so that the mercury is never completely empty nor full.
+  if (row < 0) return 0;
+  if (row > art.bar.height - 1) return art.bar.height - 1;
+  // To the nearest row. (The original, fixed-scale thermometer truncated the
+  // offset from 20 deg C instead, so its level could be up to 1 px off, e.g.
+  // at row 124 for both 19.95 and 20.06 deg C.)
+  return (int16_t)lroundf(row);
+}
+
+void Thermometer::Indicator::paintWidgetContents(const Canvas& canvas,
+                                                 Clipper& clipper) {
+  Widget::paintWidgetContents(canvas, clipper);
+  previous_height_pixels_ = temp_height_pixels_;
+  previous_color_ = temp_color_;
+}
+
 void Thermometer::Indicator::paint(const Canvas& canvas) const {
-  // For now, we use a fixed range.
+  const ThermometerArtwork& art = *artwork_;
   if (isInvalidated()) {
-    canvas.drawObject(thermometer_246x80_bounds());
-    // Draw ticks.
-    for (int i = 0; i < 33; i++) {
-      int y = (i * 5 + 15);
-      int width = 3;
-      if ((i - 4) % 20 == 0) {
-        // Full tens.
-        width = 10;
-      } else if ((i - 4) % 10 == 0) {
-        width = 7;
-      } else if ((i - 4) % 2 == 0) {
-        width = 5;
-      }
-      canvas.fillRect(46, y, 46 + width - 1, y, color::Black);
-      canvas.fillRect(46, y + 1, 46 + width - 1, y + 1, color::LightGray);
-    }
+    // The bounds, with the ticks, as a single streamed address window.
+    roo_display::DrawingContext dc(canvas);
+    dc.setFillMode(roo_display::FillMode::kExtents);
+    dc.draw(IndexedRleImage4bppxBiased(
+        Box(0, 0, art.bounds.width - 1, art.bounds.height - 1),
+        art.bounds.data, art.bounds.index, color::Black, &ticks_));
   }
 
   Canvas my_canvas = canvas;
-  my_canvas.shift(10, 10);
+  my_canvas.shift(art.bar_x, art.bar_y);
   roo_display::DrawingContext dc(my_canvas);
   dc.setFillMode(roo_display::FillMode::kVisible);
 
-  typedef RleImage4bppxBiased<Alpha4, ProgMemPtr> Img;
-  const Img& img = thermometer_246x80_bar();
-  Img top(img.extents(), img.resource(), Alpha4(theme().color.background));
-  Img bottom(img.extents(), img.resource(), Alpha4(temp_color_));
+  // The indexed images only decode the rows within the clip box.
+  Box bar_extents(0, 0, art.bar.width - 1, art.bar.height - 1);
+  IndexedRleImage4bppxBiased top(bar_extents, art.bar.data, art.bar.index,
+                                 theme().color.background);
+  IndexedRleImage4bppxBiased bottom(bar_extents, art.bar.data, art.bar.index,
+                                    temp_color_);
 
-  // Box clip = news.clip_box();
+  // Figure out the rows that need to be redrawn. If only the level changed,
+  // these are the rows between the old and the new level.
+  int16_t y_min = 0;
+  int16_t y_max = art.bar.height - 1;
+  if (!isInvalidated() && temp_color_ == previous_color_) {
+    y_min = std::min(temp_height_pixels_, previous_height_pixels_);
+    y_max = std::max(temp_height_pixels_, previous_height_pixels_) - 1;
+  }
 
-  dc.setClipBox(Box(0, 0, 57, temp_height_pixels_ - 1));
-  dc.draw(top);
+  if (y_min < temp_height_pixels_) {
+    dc.setClipBox(Box(0, y_min, art.bar.width - 1,
+                      std::min<int16_t>(temp_height_pixels_ - 1, y_max)));
+    dc.draw(top);
+  }
 
-  dc.setClipBox(Box(0, temp_height_pixels_, 57, 500));
-  dc.draw(bottom);
+  if (y_max >= temp_height_pixels_) {
+    dc.setClipBox(Box(0, std::max<int16_t>(temp_height_pixels_, y_min),
+                      art.bar.width - 1, y_max));
+    dc.draw(bottom);
+  }
 }
 
 Thermometer::Thermometer(const roo_windows::Environment& env)
-    : Thermometer(env, getDefaultColorGradient()) {}
+    : Thermometer(env, kDefaultGradientLut) {}
 
 Thermometer::Thermometer(const roo_windows::Environment& env,
                          const roo_display::ColorGradient& temp_gradient)
     : roo_windows::Panel(env),
       indicator_(env, temp_gradient),
       caption_(env, "", font_NotoSans_Regular_27(), roo_windows::kGravityTop) {
+  init();
+}
+
+Thermometer::Thermometer(const roo_windows::Environment& env,
+                         const GradientLut& temp_lut)
+    : roo_windows::Panel(env),
+      indicator_(env, temp_lut),
+      caption_(env, "", font_NotoSans_Regular_27(), roo_windows::kGravityTop) {
+  init();
+}
+
+void Thermometer::init() {
+  tempC_ = std::nanf("");
   add(indicator_);
   add(caption_);
   indicator_.setEnabled(false);
@@ -103,27 +227,63 @@ void Thermometer::setTemperature(float tempC) {
   if (tempC_ == tempC || (std::isnan(tempC_) && std::isnan(tempC))) return;
   tempC_ = tempC;
   indicator_.setTemperature(tempC);
-  caption_.setTextf("%.1f°C", tempC_);
+  caption_.setText(FormattedNumber(tempC_, kCaptionFormat).c_str());
   caption_.setVisibility(std::isnan(tempC_)
                              ? roo_windows::Visibility::kGone
                              : roo_windows::Visibility::kVisible);
 }
 
+void Thermometer::setArtwork(const ThermometerArtwork& artwork) {
+  indicator_.setArtwork(artwork);
+  requestLayout();
+}
+
+void Thermometer::setScale(float min_temp, float max_temp,
+                           float tick_spacing) {
+  indicator_.setScale(min_temp, max_temp, tick_spacing);
+}
+
+namespace {
+
+// The label needs 98x40, but is widened for larger artwork.
+XDim captionWidth(const ThermometerArtwork& artwork) {
+  return std::max<XDim>(98, artwork.bounds.width + 40);
+}
+
+}  // namespace
+
 Dimensions Thermometer::onMeasure(WidthSpec width, HeightSpec height) {
-  indicator_.measure(WidthSpec::Unspecified(58), HeightSpec::Unspecified(232));
-  caption_.measure(WidthSpec::Unspecified(98), HeightSpec::Unspecified(40));
-  Dimensions preferred(98, 280);
+  const ThermometerArtwork& art = indicator_.artwork();
+  XDim caption_width = captionWidth(art);
+  indicator_.measure(WidthSpec::Unspecified(art.bounds.width),
+                     HeightSpec::Unspecified(art.bounds.height));
+  caption_.measure(WidthSpec::Unspecified(caption_width),
+                   HeightSpec::Unspecified(40));
+  Dimensions preferred(caption_width, art.bounds.height + 48);
   return Dimensions(width.resolveSize(preferred.width()),
                     height.resolveSize(preferred.height()));
 }
 
 void Thermometer::onLayout(bool changed, const roo_windows::Rect& rect) {
-  // Pic's dimensions are 58x232. Center it horizontally, and align to top.
-  XDim xMinPic = (rect.width() - 58) / 2;
-  indicator_.layout(roo_windows::Rect(xMinPic, 0, xMinPic + 57, 231));
-  // We need 98x40 for the label.
-  XDim xMinLabel = (rect.width() - 98) / 2;
-  caption_.layout(roo_windows::Rect(xMinLabel, 240, xMinLabel + 98, 279));
+  const ThermometerArtwork& art = indicator_.artwork();
+  // Center the pic horizontally, and align to top.
+  XDim xMinPic = (rect.width() - art.bounds.width) / 2;
+  indicator_.layout(roo_windows::Rect(xMinPic, 0,
+                                      xMinPic + art.bounds.width - 1,
+                                      art.bounds.height - 1));
+  XDim caption_width = captionWidth(art);
+  YDim yMinLabel = art.bounds.height + 8;
+  XDim xMinLabel = (rect.width() - caption_width) / 2;
+  caption_.layout(roo_windows::Rect(xMinLabel, yMinLabel,
+                                    xMinLabel + caption_width,
+                                    yMinLabel + 39));
+}
+
+#if ROO_DASHBOARD_PAINT_STATS
+void Thermometer::paintWidgetContents(const Canvas& canvas, Clipper& clipper) {
+  ROO_DASHBOARD_PAINT_STATS_SCOPE("Thermometer", canvas, counted_canvas);
+  Panel::paintWidgetContents(counted_canvas, clipper);
 }
+#endif
 
 }  // namespace roo_dashboard
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <cmath>
+#include <vector>
 
+#include "roo_dashboard/core/gradient_lut.h"
+#include "roo_dashboard/core/paint_stats.h"
+#include "roo_dashboard/meters/thermometer_artwork.h"
 #include "roo_display/color/gradient.h"
 #include "roo_windows/core/panel.h"
 #include "roo_windows/core/widget.h"
@@ -9,8 +13,10 @@
 
 namespace roo_dashboard {
 
-// Analog thermometer, with range suitable for measuring indoor or swimming pool
-// temperatures (~10 - 33 deg C).
+// Analog thermometer. By default, has the scale suitable for measuring indoor
+// or swimming pool temperatures (16 - 32 deg C, with the mercury visible
+// within ~8 - 33 deg C). The scale, and the size (via the artwork), can be
+// changed.
 class Thermometer : public roo_windows::Panel {
  public:
   class Indicator : public roo_windows::Widget {
@@ -18,22 +24,102 @@ class Thermometer : public roo_windows::Panel {
     Indicator(const roo_windows::Environment& env,
               const roo_display::ColorGradient& temperature_gradient)
         : roo_windows::Widget(env),
-          temperature_gradient_(temperature_gradient) {
+          temperature_gradient_(&temperature_gradient),
+          temperature_lut_(nullptr),
+          artwork_(&defaultThermometerArtwork()),
+          min_temp_(16.0),
+          max_temp_(32.0),
+          tick_spacing_(0.5),
+          temp_height_pixels_(-1),
+          temp_color_(roo_display::color::Transparent),
+          previous_height_pixels_(-1),
+          previous_color_(roo_display::color::Transparent) {
+      updateTicks();
+      setTemperature(std::nanf(""));
+    }
+
+    Indicator(const roo_windows::Environment& env,
+              const GradientLut& temperature_lut)
+        : roo_windows::Widget(env),
+          temperature_gradient_(nullptr),
+          temperature_lut_(&temperature_lut),
+          artwork_(&defaultThermometerArtwork()),
+          min_temp_(16.0),
+          max_temp_(32.0),
+          tick_spacing_(0.5),
+          temp_height_pixels_(-1),
+          temp_color_(roo_display::color::Transparent),
+          previous_height_pixels_(-1),
+          previous_color_(roo_display::color::Transparent) {
+      updateTicks();
       setTemperature(std::nanf(""));
     }
 
     roo_windows::Dimensions getSuggestedMinimumDimensions() const override {
-      return roo_windows::Dimensions(56, 232);
+      return roo_windows::Dimensions(artwork_->bounds.width,
+                                     artwork_->bounds.height);
     }
 
+    void paintWidgetContents(const roo_windows::Canvas& canvas,
+                             roo_windows::Clipper& clipper) override;
+
     void paint(const roo_windows::Canvas& canvas) const override;
 
     void setTemperature(float tempC);
 
+    const ThermometerArtwork& artwork() const { return *artwork_; }
+
+    // The artwork must outlive the indicator.
+    void setArtwork(const ThermometerArtwork& artwork);
+
+    void setScale(float min_temp, float max_temp, float tick_spacing);
+
    private:
-    const roo_display::ColorGradient& temperature_gradient_;
+    // The scale ticks, rasterized once per scale and artwork, and drawn in
+    // the same pass as the bounds.
+    class TickLayer : public RleImageOverlay {
+     public:
+      TickLayer() : x_(0) {}
+
+      void reset(int16_t x, int16_t height);
+      void addTick(int16_t row, int16_t length);
+
+      bool getSpan(int16_t row, int16_t& col_min, int16_t& col_max,
+                   roo_display::Color& color) const override;
+
+     private:
+      int16_t x_;
+
+      // For each row, the length of the tick line, or zero. The high bit
+      // marks the (light gray) shadow line under the tick.
+      std::vector<uint8_t> rows_;
+    };
+
+    // Returns the row of the bar corresponding to the temperature.
+    int16_t rowForTemperature(float tempC) const;
+
+    void updateTicks();
+
+    // Exactly one of these is set.
+    const roo_display::ColorGradient* temperature_gradient_;
+    const GradientLut* temperature_lut_;
+
+    const ThermometerArtwork* artwork_;
+    float min_temp_;
+    float max_temp_;
+    float tick_spacing_;
+
+    float temp_c_;
+
+    TickLayer ticks_;
+
     int16_t temp_height_pixels_;
     roo_display::Color temp_color_;
+
+    // As of the last paint, so that only the rows between the old and the
+    // new level can be repainted.
+    int16_t previous_height_pixels_;
+    roo_display::Color previous_color_;
   };
 
   Thermometer(const roo_windows::Environment& env);
@@ -41,18 +127,42 @@ class Thermometer : public roo_windows::Panel {
   Thermometer(const roo_windows::Environment& env,
               const roo_display::ColorGradient& temp_gradient);
 
+  // The lookup table must outlive the thermometer.
+  Thermometer(const roo_windows::Environment& env, const GradientLut& temp_lut);
+
   void setTemperature(float tempC);
 
+  // Sets the artwork, which determines the size of the thermometer. The
+  // artwork must outlive the thermometer. Variants of different sizes can be
+  // generated at build time; see tools/thermometer_artwork.bzl.
+  void setArtwork(const ThermometerArtwork& artwork);
+
+  // Sets the temperature range (in deg C) spanned by the scale, and the
+  // spacing of the ticks. Every 2nd, 10th, and 20th tick is longer. The
+  // default is 16 - 32, with ticks every 0.5 deg C. Requires min_temp <
+  // max_temp, and a positive tick spacing; otherwise, the call is ignored.
+  // Ticks are omitted if there are more of them than rows in the artwork.
+  void setScale(float min_temp, float max_temp, float tick_spacing);
+
   roo_windows::Dimensions onMeasure(roo_windows::WidthSpec width,
                                     roo_windows::HeightSpec height) override;
 
   void onLayout(bool changed, const roo_windows::Rect& rect) override;
 
+#if ROO_DASHBOARD_PAINT_STATS
+  void paintWidgetContents(const roo_windows::Canvas& canvas,
+                           roo_windows::Clipper& clipper) override;
+#endif
+
  private:
+  void init();
+
   Indicator indicator_;
   roo_windows::TextLabel caption_;
 
   float tempC_;
+
+  ROO_DASHBOARD_PAINT_STATS_MEMBER;
 };
 
 }  // namespace roo_dashboard
\ No newline at end of file
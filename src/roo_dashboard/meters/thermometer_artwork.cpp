@@ -0,0 +1,27 @@
+#include "roo_dashboard/meters/thermometer_artwork.h"
+
+#include "roo_dashboard/meters/resources/thermometer_246x80_bar.h"
+#include "roo_dashboard/meters/resources/thermometer_246x80_bounds.h"
+
+namespace roo_dashboard {
+
+const ThermometerArtwork& defaultThermometerArtwork() {
+  static const ThermometerArtwork value{
+      .bounds = {.width = 58,
+                 .height = 232,
+                 .data = thermometer_246x80_bounds().resource(),
+                 .index = thermometer_246x80_bounds_row_index()},
+      .bar = {.width = 38,
+              .height = 212,
+              .data = thermometer_246x80_bar().resource(),
+              .index = thermometer_246x80_bar_row_index()},
+      .bar_x = 10,
+      .bar_y = 10,
+      .scale_bottom_row = 164,
+      .scale_top_row = 4,
+      .tick_x = 46,
+      .tick_lengths = {3, 5, 7, 10}};
+  return value;
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+#include "roo_dashboard/core/indexed_rle_image.h"
+
+namespace roo_dashboard {
+
+// Artwork of the Thermometer: the glass outline, and the mask of the mercury,
+// along with the geometry of the scale.
+//
+// The stock artwork is 58x232 (see defaultThermometerArtwork()). Other sizes
+// can be generated at build time, using the thermometer_artwork() Bazel macro
+// (see tools/thermometer_artwork.bzl).
+struct ThermometerArtwork {
+  struct Image {
+    int16_t width;
+    int16_t height;
+
+    // 4bpp 'biased' RLE stream (as in roo_display::RleImage4bppxBiased), in
+    // PROGMEM.
+    const uint8_t* data;
+
+    RleRowIndex index;
+  };
+
+  // Outline of the glass. Determines the size of the indicator.
+  Image bounds;
+
+  // Mask of the mercury, placed at (bar_x, bar_y) relative to the bounds.
+  Image bar;
+  int16_t bar_x;
+  int16_t bar_y;
+
+  // Rows of the bar that correspond to the bottom and the top end of the
+  // temperature range.
+  int16_t scale_bottom_row;
+  int16_t scale_top_row;
+
+  // Horizontal position of the scale ticks, relative to the bounds.
+  int16_t tick_x;
+
+  // Lengths of the ticks: minor, every 2nd, every 10th, and every 20th.
+  int16_t tick_lengths[4];
+};
+
+// The stock, 58x232 artwork (thermometer_246x80_*).
+const ThermometerArtwork& defaultThermometerArtwork();
+
+}  // namespace roo_dashboard
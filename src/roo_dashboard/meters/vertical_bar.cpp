@@ -3,7 +3,7 @@
 #include <cmath>
 
 #include "roo_display/color/color.h"
-#include "roo_io/text/string_printf.h"
+#include "roo_logging.h"
 #include "roo_smooth_fonts/NotoSans_Regular/12.h"
 #include "roo_smooth_fonts/NotoSans_Regular/18.h"
 
@@ -12,84 +12,50 @@ using namespace roo_windows;
 
 namespace roo_dashboard {
 
-void VerticalBar::Indicator::paintWidgetContents(const Canvas& canvas,
-                                                 Clipper& clipper) {
+namespace internal {
+
+void VerticalBarIndicatorBase::paintWidgetContents(const Canvas& canvas,
+                                                  Clipper& clipper) {
   Widget::paintWidgetContents(canvas, clipper);
-  previous_color_ = color_;
-  previous_value_ = value_;
+  meter_.markClean();
 }
 
-void VerticalBar::Indicator::paint(const Canvas& canvas) const {
-  // Figure out the region that needs to be redrawn.
-  roo_windows::Rect clip_box = bounds();
-  if (!isInvalidated()) {
-    if (value_ > previous_value_) {
-      clip_box =
-          roo_windows::Rect(previous_value_ + 1, 0, value_, height() - 1);
-    } else {
-      clip_box =
-          roo_windows::Rect(value_ + 1, 0, previous_value_, height() - 1);
-    }
-    if (color_ != previous_color_) {
-      // The box must include everything towards zero.
-      if (clip_box.xMin() > 1) {
-        clip_box = roo_windows::Rect(1, 0, clip_box.xMax(), height() - 1);
-      }
-      if (clip_box.xMax() < -1) {
-        clip_box = roo_windows::Rect(clip_box.xMin(), 0, -1, height() - 1);
-      }
-    }
-  }
-  Canvas my_canvas = canvas;
-  my_canvas.clipToExtents(clip_box);
-  if (!my_canvas.clip_box().empty()) {
-    Color background_color = canvas.bgcolor();
-    Color bar_color = AlphaBlend(background_color, color_);
-    Color zero_color = AlphaBlend(background_color, theme().color.onSurface);
-    my_canvas.clearRect(0, 0, std::min(value_, zero_offset_) - 1, height() - 1);
-    if (value_ < zero_offset_) {
-      my_canvas.fillRect(value_, 0, zero_offset_ - 1, height() - 1, bar_color);
-    }
-    my_canvas.drawVLine(zero_offset_, 0, height() - 1, zero_color);
-    if (value_ > zero_offset_) {
-      my_canvas.fillRect(zero_offset_ + 1, 0, value_, height() - 1, bar_color);
-    }
-    my_canvas.clearRect(std::max(value_, zero_offset_) + 1, 0, width() - 1,
-                        height() - 1);
-  }
+void VerticalBarIndicatorBase::paint(const Canvas& canvas) const {
+  meter_.paint(canvas, isInvalidated(), width(), height(),
+               theme().color.onSurface);
 }
 
-void VerticalBar::Indicator::setValue(float value) {
+int16_t VerticalBarIndicatorBase::toPixels(float value) {
   if (std::isnan(value)) {
-    value_ = 0;
     setEnabled(false);
-  } else {
-    // If we were nan (disabled) before, this will also make us dirty.
-    setEnabled(true);
-  }
-  int16_t new_value = (int16_t)(value * scale_) + zero_offset_;
-  Color new_color = color_fn_(new_value);
-  if (new_value != value_ || new_color != color_) {
-    previous_value_ = value_;
-    previous_color_ = color_;
-    value_ = new_value;
-    color_ = new_color;
-    setDirty();
+    return meter_.zero();
   }
+  // If we were nan (disabled) before, this will also make us dirty.
+  setEnabled(true);
+  return (int16_t)(value * scale_) + meter_.zero();
+}
+
+void VerticalBarIndicatorBase::update(int16_t value, Color color) {
+  if (meter_.set(value, color)) setDirty();
 }
 
-VerticalBar::VerticalBar(const roo_windows::Environment& env, float scale,
-                         int16_t zero_offset,
-                         std::function<roo_display::Color(float val)> color_fn,
-                         std::string title, std::string caption_template,
-                         float initial_value)
+VerticalBarBase::VerticalBarBase(const roo_windows::Environment& env,
+                                 std::string title,
+                                 VerticalBarIndicatorBase& indicator)
     : Panel(env),
       title_(env, std::move(title), font_NotoSans_Regular_12(),
              roo_windows::kGravityLeft | roo_windows::kGravityBottom),
-      indicator_(env, scale, zero_offset, color_fn, initial_value),
+      indicator_(indicator),
       caption_(env, "", font_NotoSans_Regular_18(),
                roo_windows::kGravityLeft | roo_windows::kGravityTop),
-      caption_template_(std::move(caption_template)) {
+      value_(std::nanf("")) {}
+
+void VerticalBarBase::init(const std::string& caption_template) {
+  // Parsed once; formatting the caption then needs no heap allocations.
+  if (!NumberFormat::Parse(caption_template.c_str(), caption_format_)) {
+    LOG(WARNING) << "Unsupported caption template: " << caption_template;
+    caption_format_ = NumberFormat();
+  }
   add(title_);
   add(indicator_);
   add(caption_);
@@ -97,24 +63,25 @@ VerticalBar::VerticalBar(const roo_windows::Environment& env, float scale,
   caption_.setPadding(roo_windows::PaddingSize::kNone);
 }
 
-void VerticalBar::setValue(float value) {
-  if (value_ == value || (std::isnan(value_) && std::isnan(value))) return;
+bool VerticalBarBase::updateCaption(float value) {
+  if (value_ == value || (std::isnan(value_) && std::isnan(value))) {
+    return false;
+  }
   value_ = value;
-  indicator_.setValue(value);
-  caption_.setTextf(caption_template_.c_str(), value_);
+  caption_.setText(FormattedNumber(value_, caption_format_).c_str());
   caption_.setVisibility(std::isnan(value_)
                              ? roo_windows::Visibility::kGone
                              : roo_windows::Visibility::kVisible);
+  return true;
 }
 
-Dimensions VerticalBar::onMeasure(WidthSpec width, HeightSpec height) {
+Dimensions VerticalBarBase::onMeasure(WidthSpec width, HeightSpec height) {
   Dimensions title = title_.measure(width, HeightSpec::Unspecified(18));
   indicator_.measure(width, HeightSpec::Unspecified(25));
   caption_.measure(WidthSpec::Unspecified(0), HeightSpec::Unspecified(0));
-  std::string test_str = roo_io::StringPrintf(caption_template_.c_str(),
-                                              (500.0 / indicator_.scale()));
+  FormattedNumber test_str(500.0 / indicator_.scale(), caption_format_);
   int16_t preferred_width =
-      caption_.font().getHorizontalStringMetrics(test_str).width();
+      caption_.font().getHorizontalStringMetrics(test_str.c_str()).width();
   Dimensions preferred(
       std::max(preferred_width, title.width()) + indicator_.zero_offset(),
       title_.font().metrics().maxHeight() + 25 +
@@ -123,7 +90,7 @@ Dimensions VerticalBar::onMeasure(WidthSpec width, HeightSpec height) {
                     height.resolveSize(preferred.height()));
 }
 
-void VerticalBar::onLayout(bool changed, const roo_windows::Rect& rect) {
+void VerticalBarBase::onLayout(bool changed, const roo_windows::Rect& rect) {
   YDim bar_height = rect.height() - title_.font().metrics().maxHeight() -
                     caption_.font().metrics().maxHeight();
   int16_t y_min = 0;
@@ -138,4 +105,14 @@ void VerticalBar::onLayout(bool changed, const roo_windows::Rect& rect) {
                                     rect.width() - 1, rect.height() - 1));
 }
 
+#if ROO_DASHBOARD_PAINT_STATS
+void VerticalBarBase::paintWidgetContents(const Canvas& canvas,
+                                          Clipper& clipper) {
+  ROO_DASHBOARD_PAINT_STATS_SCOPE("VerticalBar", canvas, counted_canvas);
+  Panel::paintWidgetContents(counted_canvas, clipper);
+}
+#endif
+
+}  // namespace internal
+
 }  // namespace roo_dashboard
@@ -3,6 +3,11 @@
 #include <functional>
 #include <string>
 
+#include "roo_dashboard/core/gradient_lut.h"
+#include "roo_dashboard/core/linear_meter.h"
+#include "roo_dashboard/core/number_format.h"
+#include "roo_dashboard/core/paint_stats.h"
+#include "roo_dashboard/core/value_animator.h"
 #include "roo_windows/core/canvas.h"
 #include "roo_windows/core/panel.h"
 #include "roo_windows/core/preferred_size.h"
@@ -11,75 +16,238 @@
 
 namespace roo_dashboard {
 
-class VerticalBar : public roo_windows::Panel {
- public:
-  class Indicator : public roo_windows::Widget {
-   public:
-    Indicator(const roo_windows::Environment& env, float scale,
-              int16_t zero_offset,
-              std::function<roo_display::Color(float val)> color_fn,
-              float initial_value)
-        : roo_windows::Widget(env),
-          scale_(scale),
-          zero_offset_(zero_offset),
-          color_fn_(color_fn),
-          value_(-1),
-          color_(roo_display::color::Transparent) {
-      setValue(initial_value);
-    }
+// Color policies for the bar. The policy is called with the position of the
+// end of the bar, in pixels (i.e., value * scale + zero_offset).
+//
+// The policy is a template parameter of BasicVerticalBar, so that it gets
+// inlined, and takes no more space than its parameters.
 
-    roo_windows::Dimensions getSuggestedMinimumDimensions() const override {
-      return roo_windows::Dimensions(50, 10);
-    }
+// The same color, regardless of the value.
+struct ConstantBarColor {
+  roo_display::Color color;
 
-    roo_windows::PreferredSize getPreferredSize() const override {
-      using roo_windows::PreferredSize;
-      return PreferredSize(PreferredSize::MatchParentWidth(),
-                           PreferredSize::WrapContentHeight());
-    }
+  roo_display::Color operator()(float val) const { return color; }
+};
 
-    void paintWidgetContents(const roo_windows::Canvas& canvas,
-                             roo_windows::Clipper& clipper) override;
-    void paint(const roo_windows::Canvas& canvas) const override;
+// One color below the threshold, and another at or above it.
+struct ThresholdBarColor {
+  float threshold;
+  roo_display::Color below;
+  roo_display::Color above;
 
-    void setValue(float value);
+  roo_display::Color operator()(float val) const {
+    return val < threshold ? below : above;
+  }
+};
 
-    int16_t zero_offset() const { return zero_offset_; }
-    float scale() const { return scale_; }
+// Color from the lookup table, which must outlive the bar.
+struct LutBarColor {
+  const GradientLut* lut;
 
-   private:
-    float scale_;
-    int16_t zero_offset_;
-    std::function<roo_display::Color(float val)> color_fn_;
+  roo_display::Color operator()(float val) const { return lut->getColor(val); }
+};
 
-    int16_t value_;
-    roo_display::Color color_;
+// Type-erased policy, used by VerticalBar: either an arbitrary function, or
+// a lookup table (which must outlive the bar).
+class DynamicBarColor {
+ public:
+  DynamicBarColor(std::function<roo_display::Color(float val)> color_fn)
+      : color_fn_(std::move(color_fn)), color_lut_(nullptr) {}
 
-    roo_display::Color previous_color_;
-    int16_t previous_value_;
-  };
+  DynamicBarColor(const GradientLut& color_lut)
+      : color_fn_(nullptr), color_lut_(&color_lut) {}
 
-  VerticalBar(const roo_windows::Environment& env, float scale,
-              int16_t zero_offset,
-              std::function<roo_display::Color(float val)> color_fn,
-              std::string title, std::string caption_template,
-              float initial_value = 0.0);
+  roo_display::Color operator()(float val) const {
+    return color_lut_ != nullptr ? color_lut_->getColor(val) : color_fn_(val);
+  }
+
+ private:
+  std::function<roo_display::Color(float val)> color_fn_;
+  // If not null, used instead of color_fn_.
+  const GradientLut* color_lut_;
+};
+
+namespace internal {
 
-  void setValue(float value);
+// The parts of BasicVerticalBar::Indicator that do not depend on the color
+// policy.
+class VerticalBarIndicatorBase : public roo_windows::Widget {
+ public:
+  roo_windows::Dimensions getSuggestedMinimumDimensions() const override {
+    return roo_windows::Dimensions(50, 10);
+  }
+
+  roo_windows::PreferredSize getPreferredSize() const override {
+    using roo_windows::PreferredSize;
+    return PreferredSize(PreferredSize::MatchParentWidth(),
+                         PreferredSize::WrapContentHeight());
+  }
+
+  void paintWidgetContents(const roo_windows::Canvas& canvas,
+                           roo_windows::Clipper& clipper) override;
+  void paint(const roo_windows::Canvas& canvas) const override;
+
+  int16_t zero_offset() const { return meter_.zero(); }
+  float scale() const { return scale_; }
+
+ protected:
+  VerticalBarIndicatorBase(const roo_windows::Environment& env, float scale,
+                           int16_t zero_offset)
+      : roo_windows::Widget(env),
+        scale_(scale),
+        meter_(zero_offset) {}
+
+  // Returns the position of the end of the bar, in pixels. Disables the
+  // indicator if the value is NaN, and enables it otherwise.
+  int16_t toPixels(float value);
+
+  // Moves the end of the bar to the specified position, painting it in the
+  // specified color.
+  void update(int16_t value, roo_display::Color color);
+
+ private:
+  float scale_;
+  LinearMeter<HorizontalOrientation> meter_;
+};
 
+// The parts of BasicVerticalBar that do not depend on the color policy.
+class VerticalBarBase : public roo_windows::Panel {
+ public:
   roo_windows::Dimensions onMeasure(roo_windows::WidthSpec width,
                                     roo_windows::HeightSpec height) override;
 
   void onLayout(bool changed, const roo_windows::Rect& rect) override;
 
+  // The value shown in the caption.
+  float value() const { return value_; }
+
+#if ROO_DASHBOARD_PAINT_STATS
+  void paintWidgetContents(const roo_windows::Canvas& canvas,
+                           roo_windows::Clipper& clipper) override;
+#endif
+
+ protected:
+  // The indicator is owned by the subclass; it is not accessed until init().
+  VerticalBarBase(const roo_windows::Environment& env, std::string title,
+                  VerticalBarIndicatorBase& indicator);
+
+  void init(const std::string& caption_template);
+
+  // Updates the caption. Returns false if the value has not changed.
+  bool updateCaption(float value);
+
  private:
   roo_windows::TextLabel title_;
-  Indicator indicator_;
+  VerticalBarIndicatorBase& indicator_;
   roo_windows::TextLabel caption_;
 
-  const std::string caption_template_;
+  NumberFormat caption_format_;
 
   float value_;
+
+  ROO_DASHBOARD_PAINT_STATS_MEMBER;
+};
+
+}  // namespace internal
+
+// A bar with a title above it, and the value as a caption below it. The bar
+// extends horizontally from zero_offset (in pixels), by scale pixels per unit
+// of the value.
+//
+// The ColorPolicy is a copyable callable, mapping the position of the end of
+// the bar to the color; see ConstantBarColor, ThresholdBarColor, and
+// LutBarColor. For an arbitrary function, use VerticalBar.
+//
+// The caption_template is a printf-style template with a single
+// floating-point conversion, e.g. "%.1f%%" (see NumberFormat::Parse).
+template <typename ColorPolicy>
+class BasicVerticalBar : public internal::VerticalBarBase {
+ public:
+  class Indicator : public internal::VerticalBarIndicatorBase {
+   public:
+    Indicator(const roo_windows::Environment& env, float scale,
+              int16_t zero_offset, ColorPolicy color_policy,
+              float initial_value)
+        : internal::VerticalBarIndicatorBase(env, scale, zero_offset),
+          color_policy_(std::move(color_policy)) {
+      setValue(initial_value);
+    }
+
+    void setValue(float value) {
+      int16_t new_value = toPixels(value);
+      update(new_value, color_policy_(new_value));
+    }
+
+   private:
+    ColorPolicy color_policy_;
+  };
+
+  BasicVerticalBar(const roo_windows::Environment& env, float scale,
+                   int16_t zero_offset, ColorPolicy color_policy,
+                   std::string title, const std::string& caption_template,
+                   float initial_value = 0.0)
+      : internal::VerticalBarBase(env, std::move(title), indicator_),
+        indicator_(env, scale, zero_offset, std::move(color_policy),
+                   initial_value) {
+    init(caption_template);
+    setValue(initial_value);
+  }
+
+  // If animation is enabled, the caption shows the new value right away,
+  // and the bar moves toward it, on each animate().
+  void setValue(float value) {
+    if (!updateCaption(value)) return;
+    if (animator_.enabled()) {
+      animator_.setTarget(value);
+      // Unless it jumped straight to the target (e.g., to or from NaN).
+      if (animator_.isAnimating()) return;
+    }
+    indicator_.setValue(value);
+  }
+
+  // Enables (or, with zero settle_time, disables) animated bar movement.
+  // The animation must then be driven by an AnimationClock.
+  void setAnimation(const AnimationSpec& spec) {
+    // Finish any animation in progress.
+    animator_.setSpec(spec);
+    animator_.jumpTo(value());
+    indicator_.setValue(value());
+  }
+
+  // Advances the bar animation. Returns true while in progress.
+  bool animate(roo_time::Uptime now) {
+    if (animator_.step(now)) indicator_.setValue(animator_.value());
+    return animator_.isAnimating();
+  }
+
+ private:
+  Indicator indicator_;
+  ValueAnimator animator_;
+};
+
+// Vertical bar with the color given by an arbitrary function, or by a lookup
+// table. Prefer BasicVerticalBar with a specific policy when there are many
+// bars, as it saves the std::function (both the RAM and the indirect call
+// on every update).
+class VerticalBar : public BasicVerticalBar<DynamicBarColor> {
+ public:
+  VerticalBar(const roo_windows::Environment& env, float scale,
+              int16_t zero_offset,
+              std::function<roo_display::Color(float val)> color_fn,
+              std::string title, std::string caption_template,
+              float initial_value = 0.0)
+      : BasicVerticalBar(env, scale, zero_offset,
+                         DynamicBarColor(std::move(color_fn)),
+                         std::move(title), caption_template, initial_value) {}
+
+  // As above, with the bar colors taken from the lookup table, which must
+  // outlive the bar. The table is indexed the same way as color_fn.
+  VerticalBar(const roo_windows::Environment& env, float scale,
+              int16_t zero_offset, const GradientLut& color_lut,
+              std::string title, std::string caption_template,
+              float initial_value = 0.0)
+      : BasicVerticalBar(env, scale, zero_offset, DynamicBarColor(color_lut),
+                         std::move(title), caption_template, initial_value) {}
 };
 
 }  // namespace roo_dashboard
@@ -0,0 +1,234 @@
+#include "roo_dashboard/core/dashboard_scheduler.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace roo_dashboard {
+
+namespace {
+
+// Records the updates applied to the slots.
+class Recorder {
+ public:
+  int addSlot(DashboardScheduler& scheduler, uint8_t priority = 0) {
+    int id = applied_.size();
+    applied_.emplace_back();
+    return scheduler.addSlot(
+        [this, id](float v) {
+          applied_[id].push_back(v);
+          order_.push_back(id);
+        },
+        priority);
+  }
+
+  const std::vector<float>& applied(int slot) const { return applied_[slot]; }
+
+  // Slots, in the order of the updates.
+  const std::vector<int>& order() const { return order_; }
+
+  void clearOrder() { order_.clear(); }
+
+ private:
+  std::vector<std::vector<float>> applied_;
+  std::vector<int> order_;
+};
+
+// Makes the scheduler learn the repaint cost of the slot, by applying an
+// update of it alone.
+void Measure(DashboardScheduler& scheduler, int slot, int64_t cost_micros) {
+  scheduler.post(slot, 0);
+  scheduler.runFrame();
+  scheduler.frameFinished(roo_time::Micros(cost_micros));
+}
+
+// Lets the time pass, so that updates posted before and after are ordered
+// by urgency.
+void Wait(int millis) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+}
+
+}  // namespace
+
+TEST(DashboardScheduler, AppliesTheLatestPostedValue) {
+  DashboardScheduler scheduler(roo_time::Millis(10));
+  Recorder recorder;
+  int a = recorder.addSlot(scheduler);
+  scheduler.runFrame();
+  EXPECT_TRUE(recorder.applied(a).empty());
+
+  scheduler.post(a, 1);
+  scheduler.post(a, 2);
+  EXPECT_EQ(1, scheduler.pendingCount());
+  scheduler.runFrame();
+  EXPECT_EQ(std::vector<float>({2}), recorder.applied(a));
+  EXPECT_EQ(0, scheduler.pendingCount());
+  EXPECT_EQ(2u, scheduler.stats().frames);
+  EXPECT_EQ(2u, scheduler.stats().posted);
+  EXPECT_EQ(1u, scheduler.stats().coalesced);
+  EXPECT_EQ(1u, scheduler.stats().applied);
+  EXPECT_EQ(0u, scheduler.stats().deferred);
+}
+
+TEST(DashboardScheduler, UnmeasuredSlotsAreFree) {
+  DashboardScheduler scheduler(roo_time::Micros(1));
+  Recorder recorder;
+  int a = recorder.addSlot(scheduler);
+  int b = recorder.addSlot(scheduler);
+  scheduler.post(a, 1);
+  scheduler.post(b, 2);
+  scheduler.runFrame();
+  EXPECT_EQ(1u, recorder.applied(a).size());
+  EXPECT_EQ(1u, recorder.applied(b).size());
+}
+
+TEST(DashboardScheduler, PacksTheBudget) {
+  DashboardScheduler scheduler(roo_time::Micros(1000));
+  Recorder recorder;
+  int a = recorder.addSlot(scheduler);
+  int b = recorder.addSlot(scheduler);
+  int c = recorder.addSlot(scheduler);
+  Measure(scheduler, a, 600);
+  Measure(scheduler, b, 600);
+  Measure(scheduler, c, 300);
+  recorder.clearOrder();
+  scheduler.resetStats();
+
+  // Most urgent first: a, b, c. After a, b doesn't fit, but c does.
+  scheduler.post(a, 1);
+  Wait(2);
+  scheduler.post(b, 2);
+  Wait(2);
+  scheduler.post(c, 3);
+  scheduler.runFrame();
+  EXPECT_EQ(std::vector<int>({a, c}), recorder.order());
+  EXPECT_EQ(1, scheduler.pendingCount());
+  EXPECT_EQ(1u, scheduler.stats().deferred);
+
+  scheduler.frameFinished(roo_time::Micros(900));
+  scheduler.runFrame();
+  EXPECT_EQ(std::vector<int>({a, c, b}), recorder.order());
+  EXPECT_EQ(0, scheduler.pendingCount());
+}
+
+TEST(DashboardScheduler, AppliesAtLeastOneUpdatePerFrame) {
+  DashboardScheduler scheduler(roo_time::Micros(10));
+  Recorder recorder;
+  int a = recorder.addSlot(scheduler);
+  int b = recorder.addSlot(scheduler);
+  Measure(scheduler, a, 100);
+  Measure(scheduler, b, 100);
+  recorder.clearOrder();
+  scheduler.resetStats();
+
+  scheduler.post(b, 1);
+  Wait(2);
+  scheduler.post(a, 2);
+  scheduler.runFrame();
+  EXPECT_EQ(std::vector<int>({b}), recorder.order());
+  EXPECT_EQ(1u, scheduler.stats().deferred);
+  scheduler.frameFinished(roo_time::Micros(100));
+  scheduler.runFrame();
+  EXPECT_EQ(std::vector<int>({b, a}), recorder.order());
+  EXPECT_EQ(1u, scheduler.stats().deferred);
+  EXPECT_EQ(2u, scheduler.stats().applied);
+}
+
+TEST(DashboardScheduler, PriorityMakesUpdatesUrgentFaster) {
+  DashboardScheduler scheduler(roo_time::Micros(10));
+  Recorder recorder;
+  int low = recorder.addSlot(scheduler, 0);
+  int high = recorder.addSlot(scheduler, 255);
+  Measure(scheduler, low, 100);
+  Measure(scheduler, high, 100);
+  recorder.clearOrder();
+
+  scheduler.post(low, 1);
+  Wait(2);
+  scheduler.post(high, 2);
+  Wait(5);
+  scheduler.runFrame();
+  EXPECT_EQ(std::vector<int>({high}), recorder.order());
+}
+
+TEST(DashboardScheduler, MaxLatency) {
+  DashboardScheduler scheduler(roo_time::Millis(10));
+  Recorder recorder;
+  int a = recorder.addSlot(scheduler);
+  scheduler.post(a, 1);
+  Wait(5);
+  scheduler.runFrame();
+  EXPECT_GE(scheduler.stats().max_latency_micros, 5000u);
+  scheduler.resetStats();
+  EXPECT_EQ(0u, scheduler.stats().max_latency_micros);
+}
+
+TEST(DashboardScheduler, SplitsTheFrameTimeByEstimatedCost) {
+  DashboardScheduler scheduler(roo_time::Millis(10));
+  Recorder recorder;
+  int a = recorder.addSlot(scheduler);
+  int b = recorder.addSlot(scheduler);
+  EXPECT_EQ(0u, scheduler.estimatedCostMicros(a));
+
+  // No estimates yet: split equally.
+  scheduler.post(a, 1);
+  scheduler.post(b, 1);
+  scheduler.runFrame();
+  scheduler.frameFinished(roo_time::Micros(1000));
+  EXPECT_EQ(500u, scheduler.estimatedCostMicros(a));
+  EXPECT_EQ(500u, scheduler.estimatedCostMicros(b));
+
+  // Moving average, with the new measurement weighted 1/4.
+  Measure(scheduler, a, 2500);
+  EXPECT_EQ(1000u, scheduler.estimatedCostMicros(a));
+
+  // In proportion to the estimates: 2/3 and 1/3.
+  scheduler.post(a, 1);
+  scheduler.post(b, 1);
+  scheduler.runFrame();
+  scheduler.frameFinished(roo_time::Micros(3000));
+  EXPECT_EQ(1000u - 250u + 500u, scheduler.estimatedCostMicros(a));
+  EXPECT_EQ(500u - 125u + 250u, scheduler.estimatedCostMicros(b));
+}
+
+TEST(DashboardScheduler, NewSlotIsWeightedByTheOthersAverage) {
+  DashboardScheduler scheduler(roo_time::Millis(10));
+  Recorder recorder;
+  int a = recorder.addSlot(scheduler);
+  int b = recorder.addSlot(scheduler);
+  int c = recorder.addSlot(scheduler);
+  Measure(scheduler, a, 1000);
+  Measure(scheduler, b, 3000);
+  scheduler.post(a, 1);
+  scheduler.post(b, 1);
+  scheduler.post(c, 1);
+  scheduler.runFrame();
+  // Weights: 1000, 3000, and 2000 for c.
+  scheduler.frameFinished(roo_time::Micros(6000));
+  EXPECT_EQ(2000u, scheduler.estimatedCostMicros(c));
+}
+
+// A slot whose first share rounds down to zero must still count as
+// measured, rather than be weighted by the average of the others forever.
+TEST(DashboardScheduler, TinyFirstShareCountsAsMeasured) {
+  DashboardScheduler scheduler(roo_time::Millis(10));
+  Recorder recorder;
+  int a = recorder.addSlot(scheduler);
+  int b = recorder.addSlot(scheduler);
+  Measure(scheduler, a, 1000);
+  scheduler.post(a, 1);
+  scheduler.post(b, 1);
+  scheduler.runFrame();
+  scheduler.frameFinished(roo_time::Micros(1));
+  EXPECT_EQ(1u, scheduler.estimatedCostMicros(b));
+
+  scheduler.post(a, 1);
+  scheduler.post(b, 1);
+  scheduler.runFrame();
+  scheduler.frameFinished(roo_time::Micros(1000));
+  EXPECT_LT(scheduler.estimatedCostMicros(b), 10u);
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,221 @@
+#include "roo_dashboard/core/decimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace roo_dashboard {
+
+namespace {
+
+// A simple linear congruential generator, for reproducible test data.
+class Lcg {
+ public:
+  Lcg(uint32_t seed) : state_(seed) {}
+
+  uint32_t next() {
+    state_ = state_ * 1664525u + 1013904223u;
+    return state_ >> 8;
+  }
+
+ private:
+  uint32_t state_;
+};
+
+// Samples with runs of NaNs, including whole columns of them (for up to 16
+// samples per column), and repeated values.
+std::vector<float> MakeSamples(size_t count) {
+  std::vector<float> result;
+  result.reserve(count);
+  Lcg rng(1);
+  while (result.size() < count) {
+    uint32_t r = rng.next();
+    if (r % 10 == 0) {
+      size_t run = r % 37;
+      for (size_t i = 0; i < run && result.size() < count; ++i) {
+        result.push_back(NAN);
+      }
+    } else {
+      result.push_back((int)(r % 200) * 0.25f - 25.0f);
+    }
+  }
+  return result;
+}
+
+// Computes the envelope of the column the straightforward way, from all of
+// its samples.
+ColumnEnvelope Reference(const std::vector<float>& samples, uint32_t n,
+                         uint32_t samples_per_column) {
+  ColumnEnvelope e{};
+  size_t start = (size_t)n * samples_per_column;
+  for (uint32_t pos = 0; pos < samples_per_column; ++pos) {
+    if (start + pos >= samples.size()) break;
+    ++e.filled;
+    float v = samples[start + pos];
+    if (std::isnan(v)) continue;
+    if (e.count == 0) {
+      e.min = e.max = e.first = v;
+      e.min_pos = e.max_pos = e.first_pos = pos;
+      e.sum = 0;
+    }
+    if (v < e.min) {
+      e.min = v;
+      e.min_pos = pos;
+    }
+    if (v > e.max) {
+      e.max = v;
+      e.max_pos = pos;
+    }
+    e.last = v;
+    e.last_pos = pos;
+    e.sum += v;
+    ++e.count;
+  }
+  return e;
+}
+
+void ExpectEnvelope(const ColumnEnvelope& expected,
+                    const ColumnEnvelope& actual) {
+  EXPECT_EQ(expected.filled, actual.filled);
+  ASSERT_EQ(expected.count, actual.count);
+  if (expected.count == 0) return;
+  EXPECT_EQ(expected.min, actual.min);
+  EXPECT_EQ(expected.max, actual.max);
+  EXPECT_EQ(expected.first, actual.first);
+  EXPECT_EQ(expected.last, actual.last);
+  EXPECT_EQ(expected.min_pos, actual.min_pos);
+  EXPECT_EQ(expected.max_pos, actual.max_pos);
+  EXPECT_EQ(expected.first_pos, actual.first_pos);
+  EXPECT_EQ(expected.last_pos, actual.last_pos);
+  EXPECT_FLOAT_EQ(expected.sum, actual.sum);
+}
+
+// Whether the selected value is one of the LTTB candidates of the column.
+bool IsCandidate(const ColumnEnvelope& c) {
+  return (c.selected == c.first && c.selected_pos == c.first_pos) ||
+         (c.selected == c.min && c.selected_pos == c.min_pos) ||
+         (c.selected == c.max && c.selected_pos == c.max_pos) ||
+         (c.selected == c.last && c.selected_pos == c.last_pos);
+}
+
+}  // namespace
+
+TEST(Decimator, Empty) {
+  Decimator decimator(10, 4);
+  EXPECT_EQ(0u, decimator.columnCount());
+  decimator.add(nullptr, 0);
+  EXPECT_EQ(0u, decimator.columnCount());
+}
+
+TEST(Decimator, ClampsTheParameters) {
+  Decimator decimator(0, 0);
+  EXPECT_EQ(3, decimator.capacity());
+  EXPECT_EQ(1u, decimator.samplesPerColumn());
+}
+
+// Batches of various sizes, crossing the column boundaries, and wrapping
+// around the ring buffer many times.
+TEST(Decimator, MatchesReference) {
+  for (uint32_t spc : {1u, 3u, 16u}) {
+    for (size_t batch : {1u, 5u, 16u, 100u}) {
+      Decimator decimator(7, spc);
+      std::vector<float> samples = MakeSamples(2000);
+      for (size_t i = 0; i < samples.size(); i += batch) {
+        size_t n = std::min(batch, samples.size() - i);
+        decimator.add(&samples[i], n);
+        std::vector<float> added(samples.begin(), samples.begin() + i + n);
+        uint32_t count = decimator.columnCount();
+        ASSERT_EQ((i + n + spc - 1) / spc, count);
+        uint32_t oldest = count > 7 ? count - 7 : 0;
+        for (uint32_t c = oldest; c < count; ++c) {
+          SCOPED_TRACE(testing::Message()
+                       << "spc " << spc << ", batch " << batch << ", after "
+                       << i + n << " samples, column " << c);
+          ExpectEnvelope(Reference(added, c, spc), decimator.column(c));
+          if (!decimator.column(c).empty()) {
+            EXPECT_TRUE(IsCandidate(decimator.column(c)));
+          }
+        }
+      }
+    }
+  }
+}
+
+// The uninitialized 'last' of a column with no valid samples must not be
+// used. (Run under MSan or Valgrind to catch regressions.)
+TEST(Decimator, NanOnlyColumns) {
+  Decimator decimator(4, 4);
+  const float nans[] = {NAN, NAN, NAN};
+  decimator.add(nans, 3);
+  EXPECT_EQ(1u, decimator.columnCount());
+  EXPECT_TRUE(decimator.column(0).empty());
+  EXPECT_EQ(3u, decimator.column(0).filled);
+  decimator.add(NAN);
+  decimator.add(nans, 3);
+  EXPECT_EQ(2u, decimator.columnCount());
+  EXPECT_TRUE(decimator.column(0).empty());
+  EXPECT_TRUE(decimator.column(1).empty());
+
+  // A valid sample after the NaNs.
+  decimator.add(2.0f);
+  const ColumnEnvelope& c = decimator.column(1);
+  EXPECT_EQ(1u, c.count);
+  EXPECT_EQ(2.0f, c.first);
+  EXPECT_EQ(3u, c.first_pos);
+  EXPECT_EQ(2.0f, c.selected);
+  EXPECT_EQ(3u, c.selected_pos);
+
+  // A column followed by an empty one gets its LTTB value relative to its
+  // own mean.
+  const float values[] = {1, 5, 0, 1};
+  decimator.add(values, 4);
+  decimator.add(nans, 3);
+  decimator.add(NAN);
+  EXPECT_EQ(4u, decimator.columnCount());
+  EXPECT_TRUE(decimator.column(3).empty());
+  EXPECT_EQ(2.0f, decimator.selected(1));
+  EXPECT_EQ(5.0f, decimator.selected(2));
+  EXPECT_EQ(1u, decimator.column(2).selected_pos);
+}
+
+TEST(Decimator, SelectedIsFinalOnceTheNextColumnIsComplete) {
+  Decimator decimator(8, 4);
+  const float flat[] = {0, 0, 0, 0};
+  const float spike[] = {0, 10, -1, 0};
+  decimator.add(flat, 4);
+  decimator.add(spike, 4);
+  // Provisionally, the last sample.
+  EXPECT_EQ(0.0f, decimator.selected(1));
+  EXPECT_EQ(3u, decimator.column(1).selected_pos);
+
+  decimator.add(flat, 3);
+  EXPECT_EQ(0.0f, decimator.selected(1));
+  EXPECT_EQ(3u, decimator.column(1).selected_pos);
+
+  // The spike makes the largest triangle with the flat neighbors.
+  decimator.add(0.0f);
+  EXPECT_EQ(10.0f, decimator.selected(1));
+  EXPECT_EQ(1u, decimator.column(1).selected_pos);
+  // The first column starts the line, as in LTTB.
+  EXPECT_EQ(0.0f, decimator.selected(0));
+  EXPECT_EQ(0u, decimator.column(0).selected_pos);
+}
+
+TEST(Decimator, Clear) {
+  Decimator decimator(4, 2);
+  const float values[] = {1, 2, 3};
+  decimator.add(values, 3);
+  EXPECT_EQ(2u, decimator.columnCount());
+  decimator.clear();
+  EXPECT_EQ(0u, decimator.columnCount());
+  decimator.add(7.0f);
+  EXPECT_EQ(1u, decimator.columnCount());
+  EXPECT_EQ(1u, decimator.column(0).count);
+  EXPECT_EQ(1u, decimator.column(0).filled);
+  EXPECT_EQ(7.0f, decimator.column(0).min);
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,253 @@
+#include "roo_dashboard/core/linear_meter.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using roo_display::Box;
+using roo_display::Color;
+
+namespace roo_dashboard {
+
+namespace {
+
+typedef LinearMeter<HorizontalOrientation> HorizontalMeter;
+typedef LinearMeter<VerticalOrientation> VerticalMeter;
+
+// Whether the pixel at the position is filled, according to the documented
+// semantics of the meter.
+bool IsFilled(int16_t zero, int16_t end, int16_t pos) {
+  return (end > zero) ? (pos > zero && pos <= end)
+                      : (pos >= end && pos < zero);
+}
+
+bool Contains(const LinearSpanPair& spans, int16_t pos) {
+  return (pos >= spans.first.min && pos <= spans.first.max) ||
+         (pos >= spans.second.min && pos <= spans.second.max);
+}
+
+void ExpectSpan(int16_t min, int16_t max, const LinearSpan& span) {
+  EXPECT_EQ(min, span.min);
+  EXPECT_EQ(max, span.max);
+}
+
+const Color kFill(0xFFFF0000);
+const Color kEmpty(0xFF0000FF);
+
+}  // namespace
+
+TEST(LinearMeter, ChangedSpansAboveZero) {
+  LinearSpanPair spans = HorizontalMeter::ChangedSpans(10, 12, 15, false);
+  ExpectSpan(13, 15, spans.first);
+  EXPECT_TRUE(spans.second.empty());
+  spans = HorizontalMeter::ChangedSpans(10, 15, 12, false);
+  ExpectSpan(13, 15, spans.first);
+  EXPECT_TRUE(spans.second.empty());
+  spans = HorizontalMeter::ChangedSpans(10, 10, 12, false);
+  ExpectSpan(11, 12, spans.first);
+}
+
+TEST(LinearMeter, ChangedSpansBelowZero) {
+  // Filled in [end, zero - 1]: going from 5 to 3 changes pixels 3 and 4.
+  LinearSpanPair spans = HorizontalMeter::ChangedSpans(10, 5, 3, false);
+  ExpectSpan(3, 4, spans.first);
+  EXPECT_TRUE(spans.second.empty());
+  spans = HorizontalMeter::ChangedSpans(10, 3, 5, false);
+  ExpectSpan(3, 4, spans.first);
+  spans = HorizontalMeter::ChangedSpans(10, 10, 7, false);
+  ExpectSpan(7, 9, spans.first);
+  spans = HorizontalMeter::ChangedSpans(10, 7, 10, false);
+  ExpectSpan(7, 9, spans.first);
+}
+
+TEST(LinearMeter, ChangedSpansAcrossZero) {
+  // The zero line itself does not change.
+  LinearSpanPair spans = HorizontalMeter::ChangedSpans(10, 5, 15, false);
+  ExpectSpan(5, 9, spans.first);
+  ExpectSpan(11, 15, spans.second);
+  spans = HorizontalMeter::ChangedSpans(10, 15, 5, false);
+  ExpectSpan(5, 9, spans.first);
+  ExpectSpan(11, 15, spans.second);
+}
+
+TEST(LinearMeter, ChangedSpansUnchanged) {
+  EXPECT_TRUE(HorizontalMeter::ChangedSpans(10, 15, 15, false).first.empty());
+  EXPECT_TRUE(HorizontalMeter::ChangedSpans(10, 5, 5, false).first.empty());
+  EXPECT_TRUE(HorizontalMeter::ChangedSpans(10, 10, 10, false).first.empty());
+  EXPECT_TRUE(HorizontalMeter::ChangedSpans(-1, 7, 7, false).second.empty());
+}
+
+TEST(LinearMeter, ChangedSpansColorChanged) {
+  LinearSpanPair spans = HorizontalMeter::ChangedSpans(10, 5, 15, true);
+  ExpectSpan(5, 15, spans.first);
+  EXPECT_TRUE(spans.second.empty());
+  spans = HorizontalMeter::ChangedSpans(10, 12, 15, true);
+  ExpectSpan(10, 15, spans.first);
+  spans = HorizontalMeter::ChangedSpans(-1, 3, 7, true);
+  ExpectSpan(-1, 7, spans.first);
+}
+
+// Exhaustively: the spans cover exactly the pixels whose state changed, for
+// zero offsets including -1 (no zero line) and 0.
+TEST(LinearMeter, ChangedSpansCoverExactlyTheChangedPixels) {
+  for (int16_t zero : {-1, 0, 1, 7, 19}) {
+    for (int16_t old_end = -1; old_end < 20; ++old_end) {
+      for (int16_t new_end = -1; new_end < 20; ++new_end) {
+        LinearSpanPair spans =
+            HorizontalMeter::ChangedSpans(zero, old_end, new_end, false);
+        EXPECT_TRUE(spans.first.empty() || spans.second.empty() ||
+                    spans.first.max < spans.second.min);
+        for (int16_t pos = -1; pos <= 20; ++pos) {
+          bool changed =
+              IsFilled(zero, old_end, pos) != IsFilled(zero, new_end, pos);
+          EXPECT_EQ(changed, Contains(spans, pos))
+              << "zero " << zero << ", " << old_end << " -> " << new_end
+              << ", pos " << pos;
+        }
+      }
+    }
+  }
+}
+
+TEST(LinearMeter, DirtySpansAndMarkClean) {
+  HorizontalMeter meter(10);
+  EXPECT_EQ(10, meter.zero());
+  EXPECT_EQ(10, meter.end());
+  EXPECT_TRUE(meter.dirtySpans().first.empty());
+
+  // The first color set dirties the whole filled area.
+  EXPECT_TRUE(meter.set(15, kFill));
+  ExpectSpan(10, 15, meter.dirtySpans().first);
+  meter.markClean();
+  EXPECT_TRUE(meter.dirtySpans().first.empty());
+  EXPECT_FALSE(meter.set(15, kFill));
+
+  // Changes accumulate until markClean().
+  EXPECT_TRUE(meter.set(12, kFill));
+  EXPECT_TRUE(meter.set(5, kFill));
+  LinearSpanPair spans = meter.dirtySpans();
+  ExpectSpan(5, 9, spans.first);
+  ExpectSpan(11, 15, spans.second);
+  meter.markClean();
+
+  EXPECT_TRUE(meter.set(3, kFill));
+  ExpectSpan(3, 4, meter.dirtySpans().first);
+  EXPECT_TRUE(meter.dirtySpans().second.empty());
+
+  // Moving back to the clean state leaves nothing dirty.
+  EXPECT_TRUE(meter.set(5, kFill));
+  EXPECT_TRUE(meter.dirtySpans().first.empty());
+  EXPECT_TRUE(meter.dirtySpans().second.empty());
+
+  EXPECT_TRUE(meter.set(5, kEmpty));
+  ExpectSpan(5, 10, meter.dirtySpans().first);
+}
+
+TEST(LinearMeter, VerticalMeterTracksTheSameSpans) {
+  VerticalMeter meter(0);
+  meter.set(8, kFill);
+  meter.markClean();
+  meter.set(4, kFill);
+  ExpectSpan(5, 8, meter.dirtySpans().first);
+}
+
+TEST(LinearMeter, HorizontalOrientation) {
+  EXPECT_EQ(50, HorizontalOrientation::Length(50, 10));
+  roo_windows::Rect rect =
+      HorizontalOrientation::ToRect(LinearSpan{3, 7}, 50, 10);
+  EXPECT_EQ(3, rect.xMin());
+  EXPECT_EQ(0, rect.yMin());
+  EXPECT_EQ(7, rect.xMax());
+  EXPECT_EQ(9, rect.yMax());
+}
+
+// Grows from the bottom: position 0 is the bottom row.
+TEST(LinearMeter, VerticalOrientation) {
+  EXPECT_EQ(10, VerticalOrientation::Length(50, 10));
+  roo_windows::Rect rect =
+      VerticalOrientation::ToRect(LinearSpan{0, 0}, 50, 10);
+  EXPECT_EQ(0, rect.xMin());
+  EXPECT_EQ(9, rect.yMin());
+  EXPECT_EQ(49, rect.xMax());
+  EXPECT_EQ(9, rect.yMax());
+  rect = VerticalOrientation::ToRect(LinearSpan{3, 7}, 50, 10);
+  EXPECT_EQ(2, rect.yMin());
+  EXPECT_EQ(6, rect.yMax());
+}
+
+namespace {
+
+// Checks readColors() and readColorRect() of the raster, over every
+// sub-rectangle of its extents, against the expected per-pixel colors.
+template <typename Orientation>
+void CheckRaster(const LinearMeterRaster<Orientation>& raster,
+                 Color (*expected)(int16_t x, int16_t y)) {
+  Box e = raster.extents();
+  for (int16_t y = e.yMin(); y <= e.yMax(); ++y) {
+    for (int16_t x = e.xMin(); x <= e.xMax(); ++x) {
+      Color c;
+      raster.readColors(&x, &y, 1, &c);
+      EXPECT_EQ(expected(x, y).asArgb(), c.asArgb()) << x << ", " << y;
+    }
+  }
+  for (int16_t y0 = e.yMin(); y0 <= e.yMax(); ++y0) {
+    for (int16_t y1 = y0; y1 <= e.yMax(); ++y1) {
+      for (int16_t x0 = e.xMin(); x0 <= e.xMax(); ++x0) {
+        for (int16_t x1 = x0; x1 <= e.xMax(); ++x1) {
+          std::vector<Color> result((x1 - x0 + 1) * (y1 - y0 + 1));
+          bool uniform = raster.readColorRect(x0, y0, x1, y1, result.data());
+          size_t i = 0;
+          for (int16_t y = y0; y <= y1; ++y) {
+            for (int16_t x = x0; x <= x1; ++x) {
+              Color actual = uniform ? result[0] : result[i++];
+              ASSERT_EQ(expected(x, y).asArgb(), actual.asArgb())
+                  << "rect " << x0 << ", " << y0 << ", " << x1 << ", " << y1
+                  << " at " << x << ", " << y;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+// Extents at an offset, as in device coordinates; filled through position 2,
+// i.e. x <= 12.
+TEST(LinearMeterRaster, Horizontal) {
+  LinearMeterRaster<HorizontalOrientation> raster(Box(10, 20, 17, 23), 2,
+                                                  kFill, kEmpty);
+  CheckRaster(raster, [](int16_t x, int16_t y) {
+    return x <= 12 ? kFill : kEmpty;
+  });
+}
+
+TEST(LinearMeterRaster, HorizontalEmptyAndFull) {
+  CheckRaster(LinearMeterRaster<HorizontalOrientation>(Box(10, 20, 15, 22),
+                                                       -1, kFill, kEmpty),
+              [](int16_t x, int16_t y) { return kEmpty; });
+  CheckRaster(LinearMeterRaster<HorizontalOrientation>(Box(10, 20, 15, 22), 5,
+                                                       kFill, kEmpty),
+              [](int16_t x, int16_t y) { return kFill; });
+}
+
+// Filled from the bottom through position 2, i.e. y >= 25 - 2.
+TEST(LinearMeterRaster, Vertical) {
+  LinearMeterRaster<VerticalOrientation> raster(Box(10, 18, 13, 25), 2, kFill,
+                                                kEmpty);
+  CheckRaster(raster, [](int16_t x, int16_t y) {
+    return y >= 23 ? kFill : kEmpty;
+  });
+}
+
+TEST(LinearMeterRaster, VerticalEmptyAndFull) {
+  CheckRaster(LinearMeterRaster<VerticalOrientation>(Box(10, 18, 12, 23), -1,
+                                                     kFill, kEmpty),
+              [](int16_t x, int16_t y) { return kEmpty; });
+  CheckRaster(LinearMeterRaster<VerticalOrientation>(Box(10, 18, 12, 23), 5,
+                                                     kFill, kEmpty),
+              [](int16_t x, int16_t y) { return kFill; });
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,117 @@
+#include "roo_dashboard/core/number_format.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace roo_dashboard {
+
+namespace {
+
+// What printf prints, except that negative zero is shown without the sign.
+std::string Printf(float value, const NumberFormat& format) {
+  char number[64];
+  snprintf(number, sizeof(number), format.force_sign ? "%+.*f" : "%.*f",
+           format.precision, (double)value);
+  std::string result = number;
+  if (result[0] == '-' &&
+      result.find_first_not_of("-0.") == std::string::npos) {
+    result = format.force_sign ? "+" + result.substr(1) : result.substr(1);
+  }
+  if (result.size() < format.width) {
+    result = std::string(format.width - result.size(), ' ') + result;
+  }
+  return format.prefix + result + format.suffix;
+}
+
+}  // namespace
+
+// The grid from 0 to 40, in 0.01 steps, includes many values that are close
+// to ties (e.g. 0.35f is slightly below 0.35, and 0.85f slightly above).
+TEST(NumberFormat, MatchesPrintfOverGrid) {
+  for (uint8_t precision = 0; precision <= 3; ++precision) {
+    NumberFormat format{.precision = precision};
+    for (int i = -4000; i <= 4000; ++i) {
+      float value = i / 100.0f;
+      EXPECT_EQ(Printf(value, format), FormattedNumber(value, format).c_str())
+          << "value " << value << ", precision " << (int)precision;
+    }
+  }
+}
+
+TEST(NumberFormat, MatchesPrintfOnExactTies) {
+  // Exactly representable; printf rounds half to even.
+  NumberFormat format{.precision = 1};
+  for (float value : {0.25f, 0.75f, 1.25f, 2.5f, -0.25f, 10.125f, 0.375f}) {
+    for (uint8_t precision = 0; precision <= 2; ++precision) {
+      format.precision = precision;
+      EXPECT_EQ(Printf(value, format), FormattedNumber(value, format).c_str())
+          << "value " << value << ", precision " << (int)precision;
+    }
+  }
+}
+
+TEST(NumberFormat, MatchesPrintfOverWideRange) {
+  for (uint8_t precision = 0; precision <= 6; ++precision) {
+    NumberFormat format{.precision = precision};
+    float value = 1e-7f;
+    while (value < 4e9f) {
+      EXPECT_EQ(Printf(value, format), FormattedNumber(value, format).c_str())
+          << "value " << value << ", precision " << (int)precision;
+      EXPECT_EQ(Printf(-value, format),
+                FormattedNumber(-value, format).c_str())
+          << "value " << -value << ", precision " << (int)precision;
+      value *= 1.37f;
+    }
+  }
+}
+
+TEST(NumberFormat, WidthSignPrefixAndSuffix) {
+  NumberFormat format{.precision = 1,
+                      .width = 6,
+                      .force_sign = true,
+                      .prefix = "T: ",
+                      .suffix = "°C"};
+  EXPECT_STREQ("T:  +12.5°C", FormattedNumber(12.5f, format).c_str());
+  EXPECT_STREQ("T:   -3.1°C", FormattedNumber(-3.14f, format).c_str());
+  EXPECT_STREQ("T:   +0.0°C", FormattedNumber(-0.01f, format).c_str());
+  for (int i = -500; i <= 500; ++i) {
+    float value = i / 7.0f;
+    EXPECT_EQ(Printf(value, format), FormattedNumber(value, format).c_str())
+        << "value " << value;
+  }
+}
+
+TEST(NumberFormat, NanAndOverflow) {
+  NumberFormat format{.precision = 2};
+  EXPECT_STREQ("nan", FormattedNumber(NAN, format).c_str());
+  EXPECT_STREQ("ovf", FormattedNumber(5e9f, format).c_str());
+  EXPECT_STREQ("ovf", FormattedNumber(-INFINITY, format).c_str());
+}
+
+TEST(NumberFormat, Parse) {
+  NumberFormat format;
+  ASSERT_TRUE(NumberFormat::Parse("T: %+5.1f°C", format));
+  EXPECT_EQ(1, format.precision);
+  EXPECT_EQ(5, format.width);
+  EXPECT_TRUE(format.force_sign);
+  EXPECT_STREQ("T: ", format.prefix);
+  EXPECT_STREQ("°C", format.suffix);
+
+  ASSERT_TRUE(NumberFormat::Parse("%.0f%%", format));
+  EXPECT_EQ(0, format.precision);
+  EXPECT_STREQ("%", format.suffix);
+
+  ASSERT_TRUE(NumberFormat::Parse("%f", format));
+  EXPECT_EQ(6, format.precision);
+
+  EXPECT_FALSE(NumberFormat::Parse("%d", format));
+  EXPECT_FALSE(NumberFormat::Parse("no conversion", format));
+  EXPECT_FALSE(NumberFormat::Parse("%.7f", format));
+  EXPECT_FALSE(NumberFormat::Parse("%.1f % lone", format));
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,134 @@
+#include "roo_dashboard/core/polar.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+namespace roo_dashboard {
+
+namespace {
+
+constexpr double kTwoPi = 2 * 3.141592653589793238462643383279502884;
+
+double ExactSin(BinaryAngle angle) { return std::sin(angle * kTwoPi / 65536); }
+double ExactCos(BinaryAngle angle) { return std::cos(angle * kTwoPi / 65536); }
+
+}  // namespace
+
+// The documented bound: the absolute error of SinQ16 and CosQ16 is below
+// 2e-5 (about 1.3 LSB of Q16), over the full circle.
+TEST(Polar, SinCosWithinBoundOverFullCircle) {
+  double max_sin_error = 0;
+  double max_cos_error = 0;
+  for (uint32_t a = 0; a < 65536; ++a) {
+    BinaryAngle angle = (BinaryAngle)a;
+    max_sin_error = std::max(
+        max_sin_error, std::abs(SinQ16(angle) / 65536.0 - ExactSin(angle)));
+    max_cos_error = std::max(
+        max_cos_error, std::abs(CosQ16(angle) / 65536.0 - ExactCos(angle)));
+  }
+  EXPECT_LT(max_sin_error, 2e-5);
+  EXPECT_LT(max_cos_error, 2e-5);
+}
+
+TEST(Polar, SinCosExactAtQuadrantBoundaries) {
+  EXPECT_EQ(0, SinQ16(0));
+  EXPECT_EQ(kQ16One, SinQ16(16384));
+  EXPECT_EQ(0, SinQ16(32768));
+  EXPECT_EQ(-kQ16One, SinQ16(49152));
+
+  EXPECT_EQ(kQ16One, CosQ16(0));
+  EXPECT_EQ(0, CosQ16(16384));
+  EXPECT_EQ(-kQ16One, CosQ16(32768));
+  EXPECT_EQ(0, CosQ16(49152));
+}
+
+// Right around the quadrant boundaries, where the table is mirrored.
+TEST(Polar, SinCosContinuousAcrossQuadrantBoundaries) {
+  for (uint32_t boundary = 0; boundary < 65536; boundary += 16384) {
+    for (int d = -3; d <= 3; ++d) {
+      BinaryAngle angle = (BinaryAngle)(boundary + d);
+      EXPECT_NEAR(ExactSin(angle), SinQ16(angle) / 65536.0, 2e-5)
+          << "angle " << angle;
+      EXPECT_NEAR(ExactCos(angle), CosQ16(angle) / 65536.0, 2e-5)
+          << "angle " << angle;
+    }
+  }
+}
+
+TEST(Polar, DegToBinaryAngle) {
+  EXPECT_EQ(0, DegToBinaryAngle(0));
+  EXPECT_EQ(16384, DegToBinaryAngle(90));
+  EXPECT_EQ(32768, DegToBinaryAngle(180));
+  EXPECT_EQ(49152, DegToBinaryAngle(270));
+  EXPECT_EQ(0, DegToBinaryAngle(360));
+  EXPECT_EQ(49152, DegToBinaryAngle(-90));
+  EXPECT_EQ(32768, DegToBinaryAngle(-180));
+  EXPECT_EQ(16384, DegToBinaryAngle(450));
+  EXPECT_EQ(16384, DegToBinaryAngle(-630));
+}
+
+// Within one unit (~0.0055 deg) of the exact conversion, wrapped around.
+TEST(Polar, DegToBinaryAngleMatchesFloatPath) {
+  for (int i = -720 * 16; i <= 720 * 16; ++i) {
+    float deg = i / 16.0f;
+    double exact = std::fmod(deg * 65536.0 / 360.0, 65536.0);
+    if (exact < 0) exact += 65536.0;
+    double diff = std::abs(DegToBinaryAngle(deg) - exact);
+    EXPECT_LE(std::min(diff, 65536.0 - diff), 1.0) << "deg " << deg;
+  }
+}
+
+TEST(Polar, BinaryAngleToDeg) {
+  EXPECT_FLOAT_EQ(0, BinaryAngleToDeg(0));
+  EXPECT_FLOAT_EQ(90, BinaryAngleToDeg(16384));
+  EXPECT_FLOAT_EQ(-180, BinaryAngleToDeg(32768));
+  EXPECT_FLOAT_EQ(-90, BinaryAngleToDeg(49152));
+}
+
+TEST(Polar, PolarToCartExactAtQuadrantBoundaries) {
+  PolarPoint c{100, 200};
+  PolarPoint p = PolarToCart(0, 50, c);
+  EXPECT_EQ(100, p.x);
+  EXPECT_EQ(150, p.y);
+  p = PolarToCart(16384, 50, c);
+  EXPECT_EQ(150, p.x);
+  EXPECT_EQ(200, p.y);
+  p = PolarToCart(32768, 50, c);
+  EXPECT_EQ(100, p.x);
+  EXPECT_EQ(250, p.y);
+  p = PolarToCart(49152, 50, c);
+  EXPECT_EQ(50, p.x);
+  EXPECT_EQ(200, p.y);
+}
+
+// The documented bound: for radii up to 1024 px, the result is within
+// 0.07 px of the exact coordinates, plus the rounding to the nearest pixel.
+TEST(Polar, PolarToCartMatchesFloatPath) {
+  PolarPoint c{10, -20};
+  for (int16_t radius : {1, 7, 40, 100, 255, 513, 1000, 1024}) {
+    for (uint32_t a = 0; a < 65536; a += 7) {
+      BinaryAngle angle = (BinaryAngle)a;
+      PolarPoint p = PolarToCart(angle, radius, c);
+      double x = c.x + radius * ExactSin(angle);
+      double y = c.y - radius * ExactCos(angle);
+      EXPECT_LE(std::abs(p.x - x), 0.5 + 0.07)
+          << "radius " << radius << ", angle " << angle;
+      EXPECT_LE(std::abs(p.y - y), 0.5 + 0.07)
+          << "radius " << radius << ", angle " << angle;
+    }
+  }
+}
+
+// Negative radii point the opposite way.
+TEST(Polar, PolarToCartNegativeRadius) {
+  PolarPoint c{0, 0};
+  for (uint32_t a = 0; a < 65536; a += 97) {
+    PolarPoint p = PolarToCart((BinaryAngle)a, -300, c);
+    PolarPoint q = PolarToCart((BinaryAngle)(a + 32768), 300, c);
+    EXPECT_NEAR(p.x, q.x, 1);
+    EXPECT_NEAR(p.y, q.y, 1);
+  }
+}
+
+}  // namespace roo_dashboard
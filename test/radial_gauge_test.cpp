@@ -0,0 +1,69 @@
+#include "roo_dashboard/meters/radial_gauge.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "roo_display.h"
+#include "roo_display/core/offscreen.h"
+#include "roo_windows/core/application.h"
+#include "roo_windows/core/environment.h"
+
+using namespace roo_display;
+using namespace roo_windows;
+
+namespace roo_dashboard {
+
+namespace {
+
+static constexpr int16_t kWidth = 320;
+static constexpr int16_t kHeight = 240;
+
+// Renders a gauge showing the value, and returns the pixels of the screen.
+std::vector<Color> Render(bool scale_cache_enabled, float value) {
+  Offscreen<Rgb565> offscreen(kWidth, kHeight, color::Black);
+  Display display(offscreen.output());
+  display.init(color::Black);
+  Environment env;
+  Application app(&env, display);
+  RadialGauge gauge(env);
+  gauge.setScaleCacheEnabled(scale_cache_enabled);
+  gauge.setValue(value);
+  app.add(gauge, Box(0, 0, kWidth - 1, kHeight - 1));
+  app.refresh();
+  if (scale_cache_enabled) {
+    EXPECT_GT(gauge.scaleCacheMemoryUsage(), 0u);
+  }
+
+  std::vector<Color> pixels(kWidth * kHeight);
+  std::vector<int16_t> xs(kWidth);
+  std::vector<int16_t> ys(kWidth);
+  for (int16_t x = 0; x < kWidth; ++x) xs[x] = x;
+  for (int16_t y = 0; y < kHeight; ++y) {
+    std::fill(ys.begin(), ys.end(), y);
+    offscreen.readColors(&xs[0], &ys[0], kWidth, &pixels[y * kWidth]);
+  }
+  return pixels;
+}
+
+}  // namespace
+
+// The scale cache must not change what the gauge looks like.
+TEST(RadialGauge, ScaleCacheRendersTheSame) {
+  for (float value : {0.0f, 37.5f, 100.0f}) {
+    std::vector<Color> direct = Render(false, value);
+    std::vector<Color> cached = Render(true, value);
+    int mismatches = 0;
+    for (int i = 0; i < kWidth * kHeight; ++i) {
+      if (direct[i] == cached[i]) continue;
+      if (++mismatches <= 10) {
+        ADD_FAILURE() << "value " << value << ": pixel (" << i % kWidth
+                      << ", " << i / kWidth << ") differs: "
+                      << direct[i].asArgb() << " vs " << cached[i].asArgb();
+      }
+    }
+    EXPECT_EQ(0, mismatches) << "value " << value;
+  }
+}
+
+}  // namespace roo_dashboard
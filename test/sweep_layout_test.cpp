@@ -0,0 +1,126 @@
+#include "roo_dashboard/core/sweep_layout.h"
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace roo_dashboard {
+
+namespace {
+
+// What a column shows: the entry at the slot, if shown, and whether it is
+// connected to its predecessor.
+struct ColumnState {
+  bool shown;
+  uint32_t entry;
+  bool connected;
+
+  bool operator==(const ColumnState& other) const {
+    return shown == other.shown && entry == other.entry &&
+           connected == other.connected;
+  }
+};
+
+ColumnState StateOf(const SweepLayout& layout, uint16_t slot,
+                    uint32_t count) {
+  uint32_t age = layout.age(slot, count);
+  if (!layout.isShown(age, count)) return ColumnState{false, 0, false};
+  return ColumnState{true, count - 1 - age, layout.isShown(age + 1, count)};
+}
+
+std::set<uint16_t> Repainted(const SweepLayout& layout, bool full,
+                             uint32_t first_changed, uint32_t count) {
+  std::set<uint16_t> slots;
+  layout.repaint(full, first_changed, count,
+                 [&](uint16_t slot) { slots.insert(slot); });
+  return slots;
+}
+
+}  // namespace
+
+TEST(SweepLayout, RaisesTinyCapacity) {
+  EXPECT_EQ(SweepLayout::kGapColumns + 1, SweepLayout(0).capacity());
+  EXPECT_EQ(1, SweepLayout(0).shown());
+  EXPECT_EQ(100, SweepLayout(100).capacity());
+  EXPECT_EQ(100 - SweepLayout::kGapColumns, SweepLayout(100).shown());
+}
+
+TEST(SweepLayout, AgeIsRelativeToTheNewestEntry) {
+  SweepLayout layout(10);
+  // Entries 0..12; the newest (12) is in slot 2.
+  EXPECT_EQ(0, layout.age(2, 13));
+  EXPECT_EQ(1, layout.age(1, 13));
+  EXPECT_EQ(2, layout.age(0, 13));
+  EXPECT_EQ(3, layout.age(9, 13));
+  EXPECT_EQ(9, layout.age(3, 13));
+}
+
+TEST(SweepLayout, AgeDoesNotOverflow) {
+  SweepLayout layout(10);
+  uint32_t count = 0xFFFFFFFF;
+  EXPECT_EQ(0, layout.age(layout.slot(count - 1), count));
+  EXPECT_EQ(1, layout.age(layout.slot(count - 2), count));
+}
+
+TEST(SweepLayout, GapAheadOfTheNewestEntry) {
+  SweepLayout layout(10);
+  EXPECT_FALSE(layout.isShown(0, 0));
+  EXPECT_TRUE(layout.isShown(0, 1));
+  EXPECT_FALSE(layout.isShown(1, 1));
+  EXPECT_TRUE(layout.isShown(5, 100));
+  EXPECT_FALSE(layout.isShown(6, 100));
+}
+
+TEST(SweepLayout, FullRepaint) {
+  SweepLayout layout(10);
+  EXPECT_EQ(10u, Repainted(layout, true, 5, 6).size());
+  // Too many changed entries.
+  EXPECT_EQ(10u, Repainted(layout, false, 0, 6).size());
+  EXPECT_TRUE(layout.repaint(false, 0, 6, [](uint16_t) {}));
+  EXPECT_FALSE(layout.repaint(false, 1, 6, [](uint16_t) {}));
+}
+
+TEST(SweepLayout, IncrementalRepaintCoversAllChangedColumns) {
+  for (uint16_t capacity : {5, 6, 17}) {
+    SweepLayout layout(capacity);
+    for (uint32_t painted = 0; painted < 3u * capacity; ++painted) {
+      for (uint32_t count = painted; count < painted + layout.shown();
+           ++count) {
+        std::set<uint16_t> repainted =
+            Repainted(layout, false, painted, count);
+        for (uint16_t slot = 0; slot < capacity; ++slot) {
+          if (!(StateOf(layout, slot, painted) ==
+                StateOf(layout, slot, count))) {
+            EXPECT_TRUE(repainted.count(slot))
+                << "capacity " << capacity << ", " << painted << " -> "
+                << count << ", slot " << slot;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(ValueToRow, MapsTheRangeToTheHeight) {
+  EXPECT_EQ(0, ValueToRow(10, 0, 10, 11));
+  EXPECT_EQ(10, ValueToRow(0, 0, 10, 11));
+  EXPECT_EQ(5, ValueToRow(5, 0, 10, 11));
+  EXPECT_EQ(3, ValueToRow(6.8f, 0, 10, 11));
+}
+
+TEST(ValueToRow, Clamps) {
+  EXPECT_EQ(0, ValueToRow(20, 0, 10, 11));
+  EXPECT_EQ(10, ValueToRow(-20, 0, 10, 11));
+  EXPECT_EQ(0, ValueToRow(INFINITY, 0, 10, 11));
+  EXPECT_EQ(10, ValueToRow(-INFINITY, 0, 10, 11));
+}
+
+TEST(ValueToRow, EmptyRange) {
+  EXPECT_EQ(5, ValueToRow(3, 3, 3, 11));
+  EXPECT_EQ(5, ValueToRow(-100, 3, 3, 11));
+  EXPECT_EQ(5, ValueToRow(100, 3, 3, 11));
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,94 @@
+#include "roo_dashboard/core/value_animator.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+namespace roo_dashboard {
+
+namespace {
+
+AnimationSpec Spec(uint16_t max_fps = 0) {
+  return AnimationSpec{.settle_time = roo_time::Millis(300),
+                       .max_fps = max_fps,
+                       .precision = 0.01f};
+}
+
+}  // namespace
+
+TEST(ValueAnimator, DisabledJumpsToTheTarget) {
+  ValueAnimator animator;
+  EXPECT_FALSE(animator.enabled());
+  animator.setTarget(5);
+  EXPECT_EQ(5, animator.value());
+  EXPECT_FALSE(animator.isAnimating());
+  EXPECT_FALSE(animator.step(roo_time::Uptime::Now() + roo_time::Millis(20)));
+}
+
+TEST(ValueAnimator, SettlesWithoutOvershoot) {
+  ValueAnimator animator;
+  animator.setSpec(Spec());
+  animator.setTarget(10);
+  EXPECT_TRUE(animator.isAnimating());
+  roo_time::Uptime now = roo_time::Uptime::Now();
+  float previous = animator.value();
+  int steps = 0;
+  while (animator.isAnimating() && steps < 1000) {
+    now = now + roo_time::Millis(10);
+    EXPECT_TRUE(animator.step(now));
+    EXPECT_GE(animator.value(), previous);
+    EXPECT_LE(animator.value(), 10);
+    previous = animator.value();
+    ++steps;
+  }
+  EXPECT_FALSE(animator.isAnimating());
+  EXPECT_EQ(10, animator.value());
+  // About settle_time.
+  EXPECT_LT(steps, 60);
+}
+
+TEST(ValueAnimator, FpsCap) {
+  ValueAnimator animator;
+  animator.setSpec(Spec(20));
+  animator.setTarget(10);
+  roo_time::Uptime now = roo_time::Uptime::Now();
+  EXPECT_FALSE(animator.step(now + roo_time::Millis(10)));
+  EXPECT_TRUE(animator.step(now + roo_time::Millis(60)));
+}
+
+TEST(ValueAnimator, NanTargetIsSettled) {
+  ValueAnimator animator;
+  animator.setSpec(Spec());
+  animator.setTarget(NAN);
+  EXPECT_TRUE(std::isnan(animator.value()));
+  EXPECT_FALSE(animator.isAnimating());
+  EXPECT_FALSE(animator.step(roo_time::Uptime::Now() + roo_time::Millis(20)));
+  animator.jumpTo(NAN);
+  EXPECT_FALSE(animator.isAnimating());
+}
+
+TEST(ValueAnimator, JumpsFromNan) {
+  ValueAnimator animator;
+  animator.setSpec(Spec());
+  animator.setTarget(NAN);
+  animator.setTarget(5);
+  EXPECT_EQ(5, animator.value());
+  EXPECT_FALSE(animator.isAnimating());
+}
+
+TEST(AnimationClock, ReportsAnimatingUntilAllSettle) {
+  struct Animated {
+    bool animate(roo_time::Uptime now) { return --steps_left > 0; }
+    int steps_left;
+  };
+  Animated a{2};
+  Animated b{3};
+  AnimationClock clock;
+  clock.add(a);
+  clock.add(b);
+  EXPECT_TRUE(clock.tick());
+  EXPECT_TRUE(clock.tick());
+  EXPECT_FALSE(clock.tick());
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,163 @@
+#include "roo_dashboard/core/value_channel.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace roo_dashboard {
+
+namespace {
+
+static constexpr uint32_t kValueCount = 200000;
+
+// Larger than a word, so that a torn read would show as a mismatch.
+struct Reading {
+  uint32_t seq;
+  float value;
+  uint32_t check;
+};
+
+Reading MakeReading(uint32_t seq) {
+  return Reading{.seq = seq, .value = seq * 0.5f, .check = ~seq};
+}
+
+bool IsWhole(const Reading& r) {
+  return r.check == ~r.seq && r.value == r.seq * 0.5f;
+}
+
+}  // namespace
+
+TEST(LatestValueChannel, Empty) {
+  LatestValueChannel<int> channel;
+  int value = 0;
+  EXPECT_FALSE(channel.poll(value));
+}
+
+TEST(LatestValueChannel, DeliversOnlyTheLatestValue) {
+  LatestValueChannel<int> channel;
+  int value = 0;
+  channel.publish(1);
+  channel.publish(2);
+  channel.publish(3);
+  EXPECT_TRUE(channel.poll(value));
+  EXPECT_EQ(3, value);
+  EXPECT_FALSE(channel.poll(value));
+  channel.publish(4);
+  EXPECT_TRUE(channel.poll(value));
+  EXPECT_EQ(4, value);
+  EXPECT_FALSE(channel.poll(value));
+}
+
+TEST(QueuedValueChannel, DeliversAllValuesInOrder) {
+  QueuedValueChannel<int, 4> channel;
+  int value = 0;
+  EXPECT_FALSE(channel.pop(value));
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 3; ++i) EXPECT_TRUE(channel.push(round * 3 + i));
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_TRUE(channel.pop(value));
+      EXPECT_EQ(round * 3 + i, value);
+    }
+    EXPECT_FALSE(channel.pop(value));
+  }
+  EXPECT_EQ(0u, channel.dropped());
+}
+
+TEST(QueuedValueChannel, DropsValuesWhenFull) {
+  QueuedValueChannel<int, 4> channel;
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(channel.push(i));
+  EXPECT_FALSE(channel.push(4));
+  EXPECT_FALSE(channel.push(5));
+  EXPECT_EQ(2u, channel.dropped());
+  int value = 0;
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(channel.pop(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(channel.pop(value));
+}
+
+TEST(ChannelDrain, DeliversPendingValues) {
+  QueuedValueChannel<int, 4> queued;
+  LatestValueChannel<int> latest;
+  std::vector<int> received;
+  int latest_value = -1;
+  ChannelDrain drain;
+  drain.bind(queued, [&](int v) { received.push_back(v); });
+  drain.bind(latest, [&](int v) { latest_value = v; });
+  drain.drain();
+  EXPECT_TRUE(received.empty());
+  EXPECT_EQ(-1, latest_value);
+
+  for (int i = 0; i < 4; ++i) queued.push(i);
+  latest.publish(7);
+  drain.drain();
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), received);
+  EXPECT_EQ(7, latest_value);
+}
+
+// A producer thread publishes values as fast as it can, while the consumer
+// drains them. The consumer must see only whole values, in order.
+TEST(LatestValueChannel, ConcurrentProducer) {
+  LatestValueChannel<Reading> channel;
+  ChannelDrain drain;
+  uint32_t received = 0;
+  uint32_t last_seq = 0;
+  uint32_t torn = 0;
+  uint32_t out_of_order = 0;
+  drain.bind(channel, [&](const Reading& r) {
+    if (!IsWhole(r)) ++torn;
+    if (received > 0 && r.seq <= last_seq) ++out_of_order;
+    last_seq = r.seq;
+    ++received;
+  });
+  std::thread producer([&]() {
+    for (uint32_t i = 1; i <= kValueCount; ++i) {
+      channel.publish(MakeReading(i));
+    }
+  });
+  while (torn == 0 && out_of_order == 0 && last_seq < kValueCount) {
+    drain.drain();
+  }
+  producer.join();
+  EXPECT_EQ(0u, torn);
+  EXPECT_EQ(0u, out_of_order);
+  // The last value is never lost.
+  drain.drain();
+  EXPECT_EQ(kValueCount, last_seq);
+}
+
+// A producer thread pushes values as fast as the consumer drains them. The
+// consumer must see all the values, whole and in order.
+TEST(QueuedValueChannel, ConcurrentProducer) {
+  QueuedValueChannel<Reading, 1024> channel;
+  ChannelDrain drain;
+  uint32_t received = 0;
+  uint32_t torn = 0;
+  uint32_t out_of_order = 0;
+  drain.bind(channel, [&](const Reading& r) {
+    if (!IsWhole(r)) ++torn;
+    if (r.seq != received + 1) ++out_of_order;
+    ++received;
+  });
+  std::thread producer([&]() {
+    for (uint32_t i = 1; i <= kValueCount; ++i) {
+      // Wait when full, so that no values are lost.
+      while (!channel.push(MakeReading(i))) std::this_thread::yield();
+    }
+  });
+  while (torn == 0 && out_of_order == 0 && received < kValueCount) {
+    drain.drain();
+    std::this_thread::yield();
+  }
+  producer.join();
+  EXPECT_EQ(0u, torn);
+  EXPECT_EQ(0u, out_of_order);
+  EXPECT_EQ(kValueCount, received);
+  Reading extra;
+  EXPECT_FALSE(channel.pop(extra));
+}
+
+}  // namespace roo_dashboard
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""Generates the row index for a 4bpp 'biased' RLE image resource.
+
+The index lets roo_dashboard::IndexedRleImage4bppxBiased start decoding at
+(nearly) any row, instead of at the beginning of the stream. Every N rows, it
+records where the first pixel of the row is encoded: the nibble offset of the
+code that covers it, and how many pixels of that code belong to the preceding
+rows (runs can span rows).
+
+Usage:
+
+  rle_row_index.py <resource.cpp> <width> <height> [rows_per_entry]
+
+Prints the C++ definitions to append to the resource .cpp file.
+"""
+
+import os
+import re
+import sys
+
+
+def load(path):
+    src = open(path).read()
+    body = src[src.index('{') + 1:src.index('};')]
+    return bytes(int(x, 16) for x in re.findall(r'0x([0-9A-Fa-f]{2})', body))
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def nibble(self):
+        b = self.data[self.pos >> 1]
+        n = (b & 0xF) if self.pos & 1 else (b >> 4)
+        self.pos += 1
+        return n
+
+    def varint(self):
+        result = 0
+        while True:
+            n = self.nibble()
+            result = (result << 3) | (n & 7)
+            if not n & 8:
+                return result
+
+
+def codes(data, total):
+    """Yields (nibble offset, pixel count) of each code in the stream."""
+    r = Reader(data)
+    emitted = 0
+    while emitted < total:
+        offset = r.pos
+        n = r.nibble()
+        if n == 0:
+            count = 2 if r.nibble() == 0 else 1
+            if count == 2:
+                r.nibble()
+        elif n < 8:
+            count = n
+        elif n > 8:
+            count = n - 8
+        else:
+            c = r.varint()
+            if c == 0:
+                count = r.varint() + 4
+                r.nibble()
+            else:
+                count = c + 2
+                r.pos += count
+        yield offset, count
+        emitted += count
+    if emitted != total:
+        raise ValueError('stream overruns the image: %d vs %d' %
+                         (emitted, total))
+
+
+def decode(data, total):
+    """Returns the pixel values (0-15) of the stream."""
+    r = Reader(data)
+    out = []
+    while len(out) < total:
+        n = r.nibble()
+        if n == 0:
+            v = r.nibble()
+            out += [v] if v != 0 else [r.nibble()] * 2
+        elif n < 8:
+            out += [0] * n
+        elif n > 8:
+            out += [15] * (n - 8)
+        else:
+            c = r.varint()
+            if c == 0:
+                count = r.varint() + 4
+                out += [r.nibble()] * count
+            else:
+                out += [r.nibble() for _ in range(c + 2)]
+    if len(out) != total:
+        raise ValueError('stream overruns the image: %d vs %d' %
+                         (len(out), total))
+    return out
+
+
+def row_index(data, width, height, rows_per_entry):
+    entries = []
+    pixel = 0
+    for offset, count in codes(data, width * height):
+        # Record all the indexed rows that begin within this code.
+        while len(entries) * rows_per_entry < height:
+            row_start = len(entries) * rows_per_entry * width
+            if row_start >= pixel + count:
+                break
+            entries.append((offset, row_start - pixel))
+        pixel += count
+    return entries
+
+
+def main(argv):
+    path, width, height = argv[1], int(argv[2]), int(argv[3])
+    rows_per_entry = int(argv[4]) if len(argv) > 4 else 16
+    name = os.path.splitext(os.path.basename(path))[0]
+    entries = row_index(load(path), width, height, rows_per_entry)
+    for offset, skip in entries:
+        if offset > 0xFFFF or skip > 0xFFFF:
+            raise ValueError('index entry out of range')
+    print('// Row index: every %d rows, %d bytes.' %
+          (rows_per_entry, 4 * len(entries)))
+    print('static const uint16_t %s_row_index_data[] PROGMEM = {' % name)
+    line = ' '
+    for offset, skip in entries:
+        item = ' %d, %d,' % (offset, skip)
+        if len(line) + len(item) > 80:
+            print(line)
+            line = ' '
+        line += item
+    print(line)
+    print('};')
+    print()
+    print('const ::roo_dashboard::RleRowIndex& %s_row_index() {' % name)
+    print('  static const ::roo_dashboard::RleRowIndex value{')
+    print('      .rows_per_entry = %d,' % rows_per_entry)
+    print('      .entry_count = %d,' % len(entries))
+    print('      .entries = %s_row_index_data};' % name)
+    print('  return value;')
+    print('}')
+
+
+if __name__ == '__main__':
+    main(sys.argv)
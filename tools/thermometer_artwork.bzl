@@ -0,0 +1,37 @@
+"""Build-time generation of Thermometer artwork of a custom size."""
+
+load("@rules_cc//cc:cc_library.bzl", "cc_library")
+
+def thermometer_artwork(name, width, height, visibility = None):
+    """Generates thermometer artwork of the given size.
+
+    Defines a cc_library `name`, with the header `<name>.h` declaring:
+
+      const roo_dashboard::ThermometerArtwork& <name>();
+
+    Pass the result to Thermometer::setArtwork().
+
+    Args:
+      name: the name of the library, and of the accessor function.
+      width: the width of the thermometer, in pixels (at least 20).
+      height: the height of the thermometer, in pixels (at least 2 * width).
+      visibility: the visibility of the library.
+    """
+    native.genrule(
+        name = name + "_gen",
+        outs = [name + ".h", name + ".cpp"],
+        cmd = ("python3 $(location //tools:thermometer_artwork.py) " +
+               "--name=%s --width=%d --height=%d --out_dir=$(RULEDIR)") %
+              (name, width, height),
+        tools = [
+            "//tools:rle_row_index.py",
+            "//tools:thermometer_artwork.py",
+        ],
+    )
+    cc_library(
+        name = name,
+        srcs = [name + ".cpp"],
+        hdrs = [name + ".h"],
+        visibility = visibility,
+        deps = ["//:roo_dashboard"],
+    )
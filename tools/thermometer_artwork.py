@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+"""Generates thermometer artwork of a given size, for roo_dashboard::Thermometer.
+
+The artwork is drawn procedurally (the glass outline, and the mercury mask),
+anti-aliased with 4x4 supersampling, and encoded in the same 4bpp 'biased'
+RLE format as the stock thermometer_246x80_* resources, together with their
+row indexes. The proportions follow the stock 58x232 artwork.
+
+Usage:
+
+  thermometer_artwork.py --name=<name> --width=<w> --height=<h> \\
+      --out_dir=<dir>
+
+Writes <dir>/<name>.h and <dir>/<name>.cpp, defining:
+
+  const roo_dashboard::ThermometerArtwork& <name>();
+
+Normally invoked via the thermometer_artwork() Bazel macro (see
+thermometer_artwork.bzl).
+"""
+
+import argparse
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import rle_row_index  # pylint: disable=wrong-import-position
+
+SUPERSAMPLING = 4
+ROWS_PER_INDEX_ENTRY = 16
+
+
+def smin(a, b, k):
+    """Polynomial smooth minimum, for the fillet between the tube and the
+    bulb."""
+    h = max(k - abs(a - b), 0.0) / k
+    return min(a, b) - h * h * k * 0.25
+
+
+class Shape:
+    """Signed distance field of a thermometer: a vertical tube with a rounded
+    top, joined with a round bulb at the bottom."""
+
+    def __init__(self, cx, tube_top, tube_half_width, bulb_cy, bulb_radius,
+                 fillet):
+        self.cx = cx
+        self.tube_top = tube_top
+        self.hw = tube_half_width
+        self.bulb_cy = bulb_cy
+        self.bulb_r = bulb_radius
+        self.fillet = fillet
+
+    def distance(self, x, y):
+        # Tube: a capsule from the rounded top down to the bulb center.
+        top_cy = self.tube_top + self.hw
+        dy = y - min(max(y, top_cy), self.bulb_cy)
+        tube = math.hypot(x - self.cx, dy) - self.hw
+        bulb = math.hypot(x - self.cx, y - self.bulb_cy) - self.bulb_r
+        return smin(tube, bulb, self.fillet)
+
+
+def rasterize(width, height, coverage):
+    """Returns 4-bit alpha values, row by row, of the area where coverage(x, y)
+    is true, sampled on a SUPERSAMPLING x SUPERSAMPLING grid per pixel."""
+    n = SUPERSAMPLING
+    total = n * n
+    pixels = []
+    for py in range(height):
+        for px in range(width):
+            count = 0
+            for sy in range(n):
+                y = py + (sy + 0.5) / n
+                for sx in range(n):
+                    if coverage(px + (sx + 0.5) / n, y):
+                        count += 1
+            pixels.append((count * 15 + total // 2) // total)
+    return pixels
+
+
+def varint(value):
+    """Big-endian, 3 bits per nibble; the high bit means 'continued'."""
+    groups = []
+    while True:
+        groups.append(value & 7)
+        value >>= 3
+        if value == 0:
+            break
+    groups.reverse()
+    return [g | 8 for g in groups[:-1]] + [groups[-1]]
+
+
+def run_codes(value, length):
+    """Returns the nibbles encoding a run of the value, of the given length."""
+    if value in (0, 15):
+        base = 0 if value == 0 else 8
+        short = []
+        remaining = length
+        while remaining > 0:
+            n = min(remaining, 7)
+            short.append(base + n)
+            remaining -= n
+        if length >= 4:
+            long = [8] + varint(0) + varint(length - 4) + [value]
+            if len(long) < len(short):
+                return long
+        return short
+    if length >= 4:
+        return [8] + varint(0) + varint(length - 4) + [value]
+    if length == 2:
+        return [0, 0, value]
+    return [0, value] * length
+
+
+def literal_codes(values):
+    if len(values) < 3:
+        result = []
+        for v in values:
+            result += [1] if v == 0 else [0, v]
+        return result
+    return [8] + varint(len(values) - 2) + list(values)
+
+
+def encode(pixels):
+    """Encodes the 4-bit values in the 4bpp 'biased' RLE format."""
+    nibbles = []
+    literals = []
+    i = 0
+    while i < len(pixels):
+        v = pixels[i]
+        j = i
+        while j < len(pixels) and pixels[j] == v:
+            j += 1
+        length = j - i
+        # Runs of 0 and 15 are cheap; other values need 4 to pay off.
+        if length >= (2 if v in (0, 15) else 4):
+            nibbles += literal_codes(literals)
+            literals = []
+            nibbles += run_codes(v, length)
+        else:
+            literals += pixels[i:j]
+        i = j
+    nibbles += literal_codes(literals)
+    if len(nibbles) % 2:
+        # Padding; never decoded.
+        nibbles.append(0)
+    return bytes((nibbles[k] << 4) | nibbles[k + 1]
+                 for k in range(0, len(nibbles), 2))
+
+
+def format_bytes(data):
+    lines = []
+    for k in range(0, len(data), 16):
+        lines.append('  ' + ' '.join('0x%02X,' % b for b in data[k:k + 16]))
+    return '\n'.join(lines)
+
+
+def format_index(entries):
+    lines = []
+    line = ' '
+    for offset, skip in entries:
+        item = ' %d, %d,' % (offset, skip)
+        if len(line) + len(item) > 78:
+            lines.append(line)
+            line = ' '
+        line += item
+    lines.append(line)
+    return '\n'.join(lines)
+
+
+def generate(name, width, height):
+    s = width / 58.0
+    cx = width / 2.0
+    glass_r = width / 2.0 - 0.25
+    bulb_cy = height - width / 2.0
+    glass_hw = 17.5 * s
+    glass_thickness = 4.5 * s
+    fillet = 5.0 * s
+
+    margin = int(round(10 * s))
+    mercury_hw = 8.0 * s
+    mercury_r = width / 2.0 - margin
+
+    outer = Shape(cx, 0.5, glass_hw, bulb_cy, glass_r, fillet)
+    mercury = Shape(cx - margin, 0.0, mercury_hw, bulb_cy - margin, mercury_r,
+                    fillet)
+
+    bar_w = width - 2 * margin
+    bar_h = height - 2 * margin
+
+    bounds_px = rasterize(
+        width, height,
+        lambda x, y: -glass_thickness <= outer.distance(x, y) <= 0)
+    bar_px = rasterize(bar_w, bar_h,
+                       lambda x, y: mercury.distance(x, y) <= 0)
+
+    scale_top_row = int(round(4 * s))
+    scale_bottom_row = int(
+        round(bulb_cy - margin - mercury_r - 10 * s))
+    tick_x = int(cx + glass_hw)
+    tick_lengths = [max(1, int(round(l * s))) for l in (3, 5, 7, 10)]
+
+    images = []
+    for suffix, w, h, px in (('bounds', width, height, bounds_px),
+                             ('bar', bar_w, bar_h, bar_px)):
+        data = encode(px)
+        entries = rle_row_index.row_index(data, w, h, ROWS_PER_INDEX_ENTRY)
+        decoded = rle_row_index.decode(data, w * h)
+        if decoded != px:
+            raise AssertionError('RLE round trip failed for ' + suffix)
+        images.append((suffix, w, h, data, entries))
+
+    header = '''#pragma once
+
+#include "roo_dashboard/meters/thermometer_artwork.h"
+
+// Generated by tools/thermometer_artwork.py; do not edit.
+const ::roo_dashboard::ThermometerArtwork& %s();
+''' % name
+
+    out = ['#include "%s.h"' % name, '',
+           '// Generated by tools/thermometer_artwork.py; do not edit.', '',
+           'using namespace roo_display;', '']
+    for suffix, w, h, data, entries in images:
+        out.append('// %s %dx%d, 4-bit Alpha, RLE, %d bytes.' %
+                   (suffix, w, h, len(data)))
+        out.append('static const uint8_t %s_%s_data[] PROGMEM = {' %
+                   (name, suffix))
+        out.append(format_bytes(data))
+        out.append('};')
+        out.append('')
+        out.append('static const uint16_t %s_%s_row_index[] PROGMEM = {' %
+                   (name, suffix))
+        out.append(format_index(entries))
+        out.append('};')
+        out.append('')
+
+    def image(suffix, w, h, entries):
+        return '''
+          {.width = %d,
+           .height = %d,
+           .data = %s_%s_data,
+           .index = {.rows_per_entry = %d,
+                     .entry_count = %d,
+                     .entries = %s_%s_row_index}}''' % (
+            w, h, name, suffix, ROWS_PER_INDEX_ENTRY, len(entries), name,
+            suffix)
+
+    (_, bw, bh, _, be), (_, rw, rh, _, re) = images
+    out.append('''const ::roo_dashboard::ThermometerArtwork& %s() {
+  static const ::roo_dashboard::ThermometerArtwork value{
+      .bounds =%s,
+      .bar =%s,
+      .bar_x = %d,
+      .bar_y = %d,
+      .scale_bottom_row = %d,
+      .scale_top_row = %d,
+      .tick_x = %d,
+      .tick_lengths = {%s}};
+  return value;
+}''' % (name, image('bounds', bw, bh, be), image('bar', rw, rh, re), margin,
+        margin, scale_bottom_row, scale_top_row, tick_x,
+        ', '.join(str(l) for l in tick_lengths)))
+    return header, '\n'.join(out) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--name', required=True)
+    parser.add_argument('--width', type=int, required=True)
+    parser.add_argument('--height', type=int, required=True)
+    parser.add_argument('--out_dir', default='.')
+    args = parser.parse_args()
+    if args.width < 20 or args.height < 2 * args.width:
+        sys.exit('The thermometer must be at least 20 px wide, and at least '
+                 'twice as tall as it is wide.')
+    header, source = generate(args.name, args.width, args.height)
+    with open(os.path.join(args.out_dir, args.name + '.h'), 'w') as f:
+        f.write(header)
+    with open(os.path.join(args.out_dir, args.name + '.cpp'), 'w') as f:
+        f.write(source)
+
+
+if __name__ == '__main__':
+    main()